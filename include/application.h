@@ -34,13 +34,22 @@ private:
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_initialized{false};
     PlaybackState m_lastState = PlaybackState::Stopped;
-    std::condition_variable m_discordConnectCv;
-    std::mutex m_discordConnectMutex;
     time_t m_lastStartTime = 0;
+    std::string m_lastArtPath; // Enrichment arrives after the basic info, so track it too
+    std::string m_lastMalId;
+    bool m_lastEnrichmentPending = false;
+
+    // Wakes the main loop when playback changes, Discord connects, or we stop
+    std::condition_variable m_wakeCv;
+    std::mutex m_wakeMutex;
+    bool m_playbackChanged = false;
+    bool m_resendPresence = false;
 
     // Helper methods for improved readability
     void setupLogging();
+    void setupPlexCallbacks();
     void setupDiscordCallbacks();
+    void requestPresenceUpdate(bool resend);
     void updateTrayStatus(const MediaInfo &info);
     void processPlaybackInfo(const MediaInfo &info);
     void performCleanup();
@@ -68,6 +68,30 @@ public:
      */
     void setLogLevel(int level);
 
+    /**
+     * @brief Check whether looked-up metadata is cached on disk between runs
+     * @return True if the persistent metadata cache is enabled
+     */
+    bool getPersistentCacheEnabled() const;
+
+    /**
+     * @brief Enable or disable the persistent metadata cache
+     * @param enabled New setting
+     */
+    void setPersistentCacheEnabled(bool enabled);
+
+    /**
+     * @brief Get how long a Plex notification stream may stay silent before it is reconnected
+     * @return Idle timeout in seconds (0 disables the watchdog)
+     */
+    int getSSEIdleTimeout() const;
+
+    /**
+     * @brief Set the Plex notification stream idle timeout
+     * @param seconds Idle timeout in seconds (0 disables the watchdog)
+     */
+    void setSSEIdleTimeout(int seconds);
+
     //
     // Plex settings
     //
@@ -138,10 +162,12 @@ public:
      * @param publicUri Public network URI
      * @param accessToken Access token for this server
      * @param owned Whether this server is owned by the user
+     * @param uris Every connection URI advertised for the server, local ones first
      */
     void addPlexServer(const std::string &name, const std::string &clientId,
                        const std::string &localUri, const std::string &publicUri,
-                       const std::string &accessToken, bool owned = false);
+                       const std::string &accessToken, bool owned = false,
+                       const std::vector<std::string> &uris = {});
 
     /**
      * @brief Remove all configured Plex servers
@@ -208,6 +234,8 @@ private:
 
     // Configuration values
     std::atomic<int> logLevel{1};
+    std::atomic<bool> persistentCache{true};
+    std::atomic<int> sseIdleTimeout{90};
     std::atomic<uint64_t> discordClientId{1359742002618564618};
 
     // Complex types need mutex protection
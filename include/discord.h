@@ -5,6 +5,9 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <functional>
 #include <iomanip>
@@ -14,7 +17,6 @@
 #include <sstream>
 #include <string>
 #include <thread>
-#include <deque>
 
 // Platform-specific headers
 #ifdef _WIN32
@@ -31,7 +33,10 @@
 #include "discord_ipc.h"
 #include "logger.h"
 #include "models.h"
+#include "retry_policy.h"
+#include "scheduler.h"
 #include "thread_utils.h"
+#include "sliding_window_limiter.h"
 
 /**
  * Main interface for Discord Rich Presence integration
@@ -105,29 +110,74 @@ private:
 	std::thread conn_thread;
 	std::mutex mutex;
 	bool running;
-	bool needs_reconnect;
-	int reconnect_attempts;
 	bool is_playing;
 	int64_t nonce_counter;
 
 	// New members for frame queue
 	std::mutex frame_queue_mutex;
 	std::string queued_frame;
+	std::string queued_nonce;
 	bool has_queued_frame;
-	int64_t last_frame_write_time;
+	std::chrono::steady_clock::time_point last_frame_write_time;
+	Scheduler::TaskId flush_timer;
+	// Set while a flush task runs on the timer thread; flush_cv signals its end
+	bool flush_running;
+	std::condition_variable flush_cv;
+
+	// Identity of a presence for diffing: hash of the fields Discord renders, plus the
+	// playback start compared with a tolerance (a hash of 0 means "unknown")
+	struct PresenceFingerprint
+	{
+		uint64_t hash = 0;
+		int64_t start_time = 0;
+	};
+
+	// Last presence Discord acknowledged, the one waiting in the queue, and frame counters;
+	// inflight_nonce names the newest frame sent, whose reply decides acked_fingerprint
+	PresenceFingerprint acked_fingerprint;
+	PresenceFingerprint queued_fingerprint;
+	std::string inflight_nonce;
+	uint64_t frames_sent;
+	uint64_t frames_suppressed;
+
+	// Time-to-presence measurement: detection time of the queued frame's media, whether
+	// that frame is fully enriched, and the detections whose frames were already logged
+	std::chrono::steady_clock::time_point queued_detected_at;
+	bool queued_complete;
+	std::chrono::steady_clock::time_point first_frame_logged;
+	std::chrono::steady_clock::time_point full_frame_logged;
+
+	// Connection work is timed by the scheduler and carried out on conn_thread,
+	// which otherwise blocks on work_cv
+	std::mutex work_mutex;
+	std::condition_variable work_cv;
+	bool work_due;
+	bool connection_lost;
+	Scheduler::TaskId work_timer;
+	RetryPolicy retry_policy;
 
 	ConnectionCallback onConnected;
 	ConnectionCallback onDisconnected;
 
-	// For rate limiting
-	std::deque<int64_t> frame_write_times;
-	bool canSendFrame(int64_t current_time);
+	// For rate limiting (frame_queue_mutex): a short burst window and a sustained-rate window
+	SlidingWindowLimiter short_window;
+	SlidingWindowLimiter long_window;
+
+	/**
+	 * Computes how long until the rate limiter allows the next frame
+	 * Must be called with frame_queue_mutex held
+	 *
+	 * @param now Current time
+	 * @return Zero if a frame may be sent now, otherwise the exact wait
+	 */
+	std::chrono::steady_clock::duration frameDelay(std::chrono::steady_clock::time_point now) const;
 
 	/**
 	 * Persistent connection thread to Discord IPC
 	 *
 	 * This thread handles the connection to Discord and keeps it alive.
-	 * It also handles reconnections in case of disconnection with exponential backoff.
+	 * It also handles reconnections in case of disconnection with jittered exponential backoff.
+	 * Between steps it blocks until a scheduler timer hands it the next one.
 	 *
 	 * Connection flow:
 	 * 1. Attempt to open pipe connection to Discord client
@@ -138,6 +188,25 @@ private:
 	 */
 	void connectionThread();
 
+	/**
+	 * Wakes the connection thread after a delay to connect (if disconnected)
+	 * or check connection health (if connected), replacing any pending wakeup
+	 *
+	 * @param delay Time until the next step
+	 */
+	void scheduleWork(std::chrono::milliseconds delay);
+
+	/**
+	 * Wakes the connection thread immediately (e.g. after a failed write)
+	 */
+	void requestWork();
+
+	/**
+	 * Wakes the connection thread to tear down a dropped connection, notify
+	 * onDisconnected and reconnect; safe to call from the IPC reader thread
+	 */
+	void connectionLost();
+
 	/**
 	 * Checks if Discord connection is still alive by sending a ping
 	 *
@@ -146,11 +215,43 @@ private:
 	bool isStillAlive();
 
 	/**
-	 * Sends a presence update message to Discord
+	 * Sends a presence update message to Discord without waiting for the reply
 	 *
 	 * @param message The JSON payload to send
+	 * @param nonce Nonce of the payload, used to match Discord's reply
+	 * @param fingerprint Fingerprint of the payload, recorded once Discord acknowledges it
+	 * @return true if the message was written
 	 */
-	void sendPresenceMessage(const std::string &message);
+	bool sendPresenceMessage(const std::string &message, const std::string &nonce,
+							 const PresenceFingerprint &fingerprint);
+
+	/**
+	 * Handles Discord's reply to a presence update (on the IPC reader thread)
+	 *
+	 * @param reply The reply, or a failure if the connection closed first
+	 * @param nonce Nonce of the update
+	 * @param fingerprint Fingerprint of the update
+	 */
+	void onPresenceReply(const DiscordIPC::Reply &reply, const std::string &nonce,
+						 const PresenceFingerprint &fingerprint);
+
+	/**
+	 * Computes the diffing fingerprint of the activity createActivity() builds
+	 *
+	 * @param info Media information to display
+	 * @return Fingerprint of the presence
+	 */
+	static PresenceFingerprint fingerprintFor(const MediaInfo &info);
+
+	/**
+	 * Drops an update if Discord already shows an equivalent presence
+	 * A different frame still waiting in the queue is dropped too, since what
+	 * should be shown is already on screen
+	 *
+	 * @param fingerprint Fingerprint of the update
+	 * @return true if the update was suppressed
+	 */
+	bool suppressIfShown(const PresenceFingerprint &fingerprint);
 
 	/**
 	 * Attempts to establish a connection to Discord
@@ -194,10 +295,23 @@ private:
 
 	/**
 	 * Queues a presence message to be sent to Discord
+	 * A newer message replaces one that is still waiting for the rate limiter
 	 *
 	 * @param message The JSON payload to queue
+	 * @param nonce Nonce of the payload
+	 * @param fingerprint Fingerprint of the payload, remembered once Discord acknowledges it
+	 * @param info Media the message describes, for time-to-presence logging (nullptr if none)
+	 */
+	void queuePresenceMessage(const std::string &message, const std::string &nonce,
+							  const PresenceFingerprint &fingerprint, const MediaInfo *info = nullptr);
+
+	/**
+	 * Logs how long after detection the first and the fully enriched frame for a media went out
+	 *
+	 * @param detected_at When Plex first reported the media
+	 * @param complete Whether the frame had no pending enrichment
 	 */
-	void queuePresenceMessage(const std::string &message);
+	void logFrameTiming(std::chrono::steady_clock::time_point detected_at, bool complete);
     
 	/**
 	 * Processes the queued frame and sends it to Discord
@@ -206,4 +320,12 @@ private:
 	 */
 	void processQueuedFrame();
 
+	/**
+	 * Schedules processQueuedFrame unless a flush is already pending
+	 * Must be called with frame_queue_mutex held
+	 *
+	 * @param delay Time until the flush
+	 */
+	void scheduleFlush(std::chrono::milliseconds delay);
+
 };
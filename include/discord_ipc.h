@@ -1,13 +1,22 @@
 #pragma once
 
 // Standard library headers
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // Platform-specific headers
@@ -16,12 +25,19 @@
 #include <ws2tcpip.h>
 #else
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 #endif
 
+#if !defined(_WIN32) && !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0 // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+
 #if defined(_WIN32) && !defined(htole32)
 #define htole32(x) (x) // little-endian host
 #define le32toh(x) (x)
@@ -54,14 +70,40 @@ enum DiscordOpcodes
  *
  * This class manages the connection to Discord's local IPC socket/pipe,
  * allowing sending and receiving of Discord Rich Presence messages.
+ *
+ * Once the handshake is done, a dedicated reader thread owns the receive side and
+ * routes every incoming frame: replies go to the handler registered under their
+ * nonce, PONGs to the oldest outstanding ping, and unsolicited frames (DISPATCH
+ * events) are dropped. Writers therefore never wait on reads; they fire and forget
+ * or register a handler/future for the one reply they care about. The socket is
+ * non-blocking, so a write to a Discord that stops reading waits at most
+ * WRITE_TIMEOUT_MS for room, then fails and marks the connection down.
  */
 class DiscordIPC
 {
 public:
+    /**
+     * Reply to a request; ok is false if the connection closed before it arrived
+     */
+    struct Reply
+    {
+        bool ok = false;
+        int opcode = -1;
+        std::string data;
+    };
+
+    typedef std::function<void(const Reply &)> ReplyHandler;
+
+    /** Largest frame accepted from Discord by default */
+    static constexpr size_t DEFAULT_MAX_FRAME_SIZE = 1024 * 1024;
+
     /**
      * Constructor initializes the Discord IPC connection state
+     *
+     * @param max_frame_size Largest frame payload accepted from Discord; a longer
+     *                       frame is treated as a protocol error and drops the connection
      */
-    DiscordIPC();
+    explicit DiscordIPC(size_t max_frame_size = DEFAULT_MAX_FRAME_SIZE);
 
     /**
      * Destructor ensures the connection is properly closed
@@ -81,9 +123,25 @@ public:
 
     /**
      * Closes the current connection to Discord
+     *
+     * Stops the reader thread and fails all outstanding requests. Safe to call when
+     * already closed.
      */
     void closePipe();
 
+    /**
+     * Starts the reader thread; call once the handshake response has been read
+     */
+    void startReader();
+
+    /**
+     * Sets the callback invoked (on the reader thread) when the connection drops
+     * unexpectedly after startReader(); not invoked for closePipe()
+     *
+     * @param callback Function to call; must not call closePipe()
+     */
+    void setClosedCallback(std::function<void()> callback);
+
     /**
      * Checks if the connection to Discord is active
      *
@@ -94,6 +152,7 @@ public:
     // IPC operations
     /**
      * Writes a framed message to Discord
+     * Safe to call from any thread; concurrent frames are never interleaved
      *
      * @param opcode The Discord IPC opcode for this message
      * @param payload The message content as a JSON string
@@ -103,12 +162,16 @@ public:
 
     /**
      * Reads a framed message from Discord
+     * Only used before startReader(); afterwards the reader thread owns all reads
+     *
+     * Frames are cut out of a per-connection receive buffer, so frames that arrived
+     * together are returned without further syscalls and nothing is copied.
      *
      * @param opcode Output parameter that will contain the received opcode
-     * @param data Output parameter that will contain the received data
+     * @param data Output view of the received data, valid until the next readFrame()
      * @return true if read was successful, false if it failed
      */
-    bool readFrame(int &opcode, std::string &data);
+    bool readFrame(int &opcode, std::string_view &data);
 
     /**
      * Sends the initial handshake message to Discord
@@ -118,20 +181,116 @@ public:
      */
     bool sendHandshake(uint64_t clientId);
 
+    /**
+     * Sends a command frame and routes Discord's reply to a handler
+     *
+     * @param nonce Nonce of the command; Discord echoes it in the reply
+     * @param payload The command as a JSON string
+     * @param handler Called exactly once: on the reader thread with the reply, or with
+     *                ok == false if the frame could not be written or the connection
+     *                closes first
+     * @return true if the frame was written, false otherwise (the handler has then
+     *         already been called with ok == false)
+     */
+    bool sendRequest(const std::string &nonce, const std::string &payload, ReplyHandler handler);
+
     /**
      * Sends a ping message to check if Discord is still responsive
      *
-     * @return true if ping was sent successfully, false otherwise
+     * @return Future resolved with the PONG (ok == false if the ping could not be sent
+     *         or the connection closed first)
      */
-    bool sendPing();
+    std::future<Reply> ping();
 
 private:
+    /**
+     * Reader thread: reads frames until the connection drops, dispatching each one
+     */
+    void readerLoop();
+
+    /**
+     * Routes one incoming frame to whoever is waiting for it
+     */
+    void dispatchFrame(int opcode, std::string_view data);
+
+    /**
+     * Marks the connection as dropped and fails outstanding requests
+     * Invokes the closed callback on the first unexpected drop after startReader()
+     */
+    void markDisconnected();
+
+    /**
+     * Completes every outstanding request and ping with ok == false
+     */
+    void failPending();
+
+#ifdef _WIN32
+    /**
+     * Runs one overlapped read or write, giving up once closePipe() signals stop_event
+     */
+    bool overlappedIo(bool write, char *buf, DWORD len, DWORD &transferred);
+#endif
+
+    /**
+     * Makes the receive buffer hold at least needed unconsumed bytes, reading as much
+     * as fits per syscall; returns false on error or EOF
+     */
+    bool fillReceiveBuffer(size_t needed);
+
+    /**
+     * Reads whatever is available (at least one byte) into buf, returning false on
+     * error or EOF
+     */
+    bool readSome(char *buf, size_t len, size_t &received);
+
+    /**
+     * Writes a frame header followed by its payload, returning false on error
+     * Must be called with write_mutex held
+     */
+    bool writeParts(const char *header, size_t header_len, const std::string &payload);
+
     /** Flag indicating whether there's an active connection to Discord */
     std::atomic<bool> connected;
 
+    /** Set while the reader thread serves an established connection */
+    std::atomic<bool> established;
+
+    /** Serializes writers so frames are not interleaved, and writes against closing */
+    std::mutex write_mutex;
+
+    /** Receive side, running once the handshake is done */
+    std::thread reader_thread;
+
+    /** A ping awaiting its PONG; the id lets a failed send remove just its own entry */
+    struct PendingPing
+    {
+        uint64_t id;
+        ReplyHandler handler;
+    };
+
+    /** Outstanding requests by nonce and outstanding pings in send order */
+    std::mutex pending_mutex;
+    std::unordered_map<std::string, ReplyHandler> pending_requests;
+    std::deque<PendingPing> pending_pings;
+    uint64_t next_ping_id;
+
+    std::function<void()> closed_callback;
+
+    /** Receive buffer (reader side only): unconsumed bytes are [recv_start, recv_end) */
+    const size_t max_frame_size;
+    std::vector<char> recv_buffer;
+    size_t recv_start;
+    size_t recv_end;
+
 #ifdef _WIN32
     /** Windows-specific handle to the Discord IPC pipe */
     HANDLE pipe_handle;
+
+    /** Signalled by closePipe() to abort pending overlapped I/O */
+    HANDLE stop_event;
+
+    /** Frame assembly buffer reused across writes (write_mutex) */
+    std::vector<char> write_buffer;
 #else
     /** Unix-specific file descriptor for the Discord IPC socket */
     int pipe_fd;
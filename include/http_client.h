@@ -1,16 +1,14 @@
 #pragma once
 
 // Standard library headers
-#include <atomic>
-#include <condition_variable>
-#include <functional>
-#include <future>
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
-#include <thread>
+#include <vector>
 
 // Third-party headers
 #include <curl/curl.h>
@@ -20,17 +18,64 @@
 #include "logger.h"
 
 /**
- * @brief HTTP client with support for GET, POST, and Server-Sent Events (SSE)
+ * @brief Process-wide pool of reusable CURL easy handles
+ *
+ * Idle handles are kept per origin (scheme/host/port) so each one holds on to its
+ * keep-alive connection, and every handle shares the DNS and TLS session caches
+ * through a single CURLSH handle. Repeated requests to the same server therefore
+ * skip the TCP and TLS handshakes.
  */
-class HttpClient
+class HttpConnectionPool
 {
 public:
-    HttpClient();
-    ~HttpClient();
+    static HttpConnectionPool &getInstance();
+
+    /**
+     * @brief Takes an idle handle for the URL's origin, or creates a new one
+     * @param url Request URL
+     * @return A reset easy handle attached to the shared caches, or nullptr on failure
+     */
+    CURL *acquire(const std::string &url);
+
+    /**
+     * @brief Returns a handle to the pool so its connection can be reused
+     * @param url URL the handle was acquired for
+     * @param handle Handle returned by acquire()
+     */
+    void release(const std::string &url, CURL *handle);
+
+    /**
+     * @brief Attaches the shared DNS and TLS session caches to a handle not owned by the pool
+     * @param handle Easy handle to configure
+     */
+    void attachShare(CURL *handle);
 
-    // Callback type for SSE events
-    using EventCallback = std::function<void(const std::string &)>;
+private:
+    HttpConnectionPool();
+    ~HttpConnectionPool();
+    HttpConnectionPool(const HttpConnectionPool &) = delete;
+    HttpConnectionPool &operator=(const HttpConnectionPool &) = delete;
+
+    static std::string originKey(const std::string &url);
+    static void lockCallback(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+    static void unlockCallback(CURL *handle, curl_lock_data data, void *userptr);
 
+    CURLSH *m_share;
+    std::mutex m_shareLocks[CURL_LOCK_DATA_LAST];
+
+    std::mutex m_poolMutex;
+    std::map<std::string, std::vector<CURL *>> m_idleHandles;
+};
+
+/**
+ * @brief HTTP client with support for GET and POST requests
+ *
+ * Clients are lightweight; the underlying handles come from HttpConnectionPool.
+ * Server-Sent Events streams are handled by SSEReactor.
+ */
+class HttpClient
+{
+public:
     // Regular HTTP requests
     bool get(const std::string &url,
              const std::map<std::string, std::string> &headers,
@@ -41,33 +86,33 @@ public:
               const std::string &body,
               std::string &response);
 
-    // Server-Sent Events (SSE)
-    bool startSSE(const std::string &url,
-                  const std::map<std::string, std::string> &headers,
-                  EventCallback callback);
-    bool stopSSE();
+    /**
+     * @brief Races GET requests to several candidate URLs and returns the first to succeed
+     *
+     * Candidates are started in order, each `stagger` after the previous one (happy-eyeballs
+     * style), so earlier candidates get a head start but a dead one never blocks the rest.
+     * Probes use their own handles, never pooled ones, and their connections are closed
+     * when the race ends; the winner's DNS entry and TLS session stay in the shared
+     * caches, so the first real request skips the lookup and resumes the session.
+     *
+     * @param urls Candidate URLs, most preferred first
+     * @param headers Request headers
+     * @param stagger Delay between starting consecutive candidates
+     * @param timeout Overall deadline for the race
+     * @return Index of the winning URL, or -1 if none answered successfully in time
+     */
+    int race(const std::vector<std::string> &urls,
+             const std::map<std::string, std::string> &headers,
+             std::chrono::milliseconds stagger,
+             std::chrono::milliseconds timeout);
 
 private:
     // CURL callback functions
     static size_t writeCallback(char *ptr, size_t size, size_t nmemb, void *userdata);
-    static size_t sseCallback(char *ptr, size_t size, size_t nmemb, void *userdata);
-    static int sseCallbackProgress(void *clientp, curl_off_t dltotal, curl_off_t dlnow,
-                                   curl_off_t ultotal, curl_off_t ulnow);
+    static size_t discardCallback(char *ptr, size_t size, size_t nmemb, void *userdata);
 
     // Helper methods
-    bool setupCommonOptions(const std::string &url, const std::map<std::string, std::string> &headers);
+    bool setupCommonOptions(CURL *curl, const std::string &url, const std::map<std::string, std::string> &headers);
     struct curl_slist *createHeaderList(const std::map<std::string, std::string> &headers);
-    bool checkResponse(CURLcode res);
-
-    // Member variables
-    CURL *m_curl;
-    std::thread m_sseThread;
-    EventCallback m_eventCallback;
-    std::string m_sseBuffer;
-
-    // Thread synchronization for SSE
-    std::atomic<bool> m_stopFlag{false};
-    std::atomic<bool> m_sseRunning{false};
-    std::mutex m_sseMutex;
-    std::condition_variable m_sseCondVar;
+    bool checkResponse(CURL *curl, CURLcode res);
 };
@@ -0,0 +1,189 @@
+#pragma once
+
+// Standard library headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Thread-safe cache with per-entry TTL and LRU eviction
+ *
+ * Lookups and inserts are O(1): entries live in a recency list indexed by a hash map.
+ * The cache is bounded both by entry count and by an approximate byte budget computed
+ * with a caller-supplied size function; the least recently used entries are evicted
+ * first when either limit is exceeded. Expired entries are dropped when they are
+ * looked up and otherwise age out through normal eviction.
+ */
+template <typename Key, typename Value>
+class LruCache
+{
+public:
+    using Clock = std::chrono::system_clock;
+    using SizeFunction = std::function<size_t(const Key &, const Value &)>;
+
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    /**
+     * @param ttl How long an entry stays valid after it is inserted
+     * @param maxEntries Maximum number of entries (0 = unbounded)
+     * @param maxBytes Maximum approximate size of all entries (0 = unbounded)
+     * @param sizeOf Returns the approximate size of an entry; defaults to sizeof(Key) + sizeof(Value)
+     */
+    LruCache(std::chrono::seconds ttl, size_t maxEntries, size_t maxBytes = 0, SizeFunction sizeOf = nullptr)
+        : m_ttl(ttl), m_maxEntries(maxEntries), m_maxBytes(maxBytes), m_sizeOf(std::move(sizeOf))
+    {
+    }
+
+    /**
+     * @brief Looks up a valid entry and marks it most recently used
+     * @return The cached value, or std::nullopt on a miss or expired entry
+     */
+    std::optional<Value> get(const Key &key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_index.find(key);
+        if (it == m_index.end())
+        {
+            m_stats.misses++;
+            return std::nullopt;
+        }
+
+        if (it->second->expires <= Clock::now())
+        {
+            m_stats.expirations++;
+            m_stats.misses++;
+            removeEntry(it->second);
+            return std::nullopt;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        m_stats.hits++;
+        return it->second->value;
+    }
+
+    /**
+     * @brief Inserts or replaces an entry, evicting old entries to stay within budget
+     */
+    void put(const Key &key, Value value)
+    {
+        putUntil(key, std::move(value), Clock::now() + m_ttl);
+    }
+
+    /**
+     * @brief Inserts or replaces an entry with an explicit expiry time
+     *
+     * Used when restoring entries whose lifetime started elsewhere (e.g. loaded from disk).
+     */
+    void putUntil(const Key &key, Value value, Clock::time_point expires)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            removeEntry(it->second);
+        }
+
+        size_t bytes = m_sizeOf ? m_sizeOf(key, value) : sizeof(Key) + sizeof(Value);
+        m_entries.push_front(Entry{key, std::move(value), expires, bytes});
+        m_index[key] = m_entries.begin();
+        m_bytes += bytes;
+
+        evictOverBudget();
+    }
+
+    std::chrono::seconds ttl() const
+    {
+        return m_ttl;
+    }
+
+    void erase(const Key &key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            removeEntry(it->second);
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_index.clear();
+        m_bytes = 0;
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stats stats = m_stats;
+        stats.entries = m_entries.size();
+        stats.bytes = m_bytes;
+        return stats;
+    }
+
+private:
+    struct Entry
+    {
+        Key key;
+        Value value;
+        Clock::time_point expires;
+        size_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+
+    void removeEntry(typename EntryList::iterator entry)
+    {
+        m_bytes -= entry->bytes;
+        m_index.erase(entry->key);
+        m_entries.erase(entry);
+    }
+
+    void evictOverBudget()
+    {
+        auto now = Clock::now();
+        while (!m_entries.empty() &&
+               ((m_maxEntries > 0 && m_entries.size() > m_maxEntries) ||
+                (m_maxBytes > 0 && m_bytes > m_maxBytes)))
+        {
+            auto last = std::prev(m_entries.end());
+            if (last->expires <= now)
+            {
+                m_stats.expirations++;
+            }
+            else
+            {
+                m_stats.evictions++;
+            }
+            removeEntry(last);
+        }
+    }
+
+    std::chrono::seconds m_ttl;
+    size_t m_maxEntries;
+    size_t m_maxBytes;
+    SizeFunction m_sizeOf;
+
+    mutable std::mutex m_mutex;
+    EntryList m_entries; // Most recently used first
+    std::unordered_map<Key, typename EntryList::iterator> m_index;
+    size_t m_bytes = 0;
+    Stats m_stats;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+// Standard library headers
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project headers
+#include "logger.h"
+
+/**
+ * @brief Append-only on-disk store for cached metadata lookups
+ *
+ * Every record carries its table, key, value and absolute expiry time. Records are
+ * appended as they are produced, so a crash loses at most the record being written;
+ * when the store is loaded, later records for the same key win, expired ones are
+ * skipped, and the file is compacted if it is mostly garbage.
+ *
+ * File layout (integers little-endian):
+ *   header: "PFPM" magic, uint32 version
+ *   record: uint8 table, int64 expiry (unix seconds), uint32 key length,
+ *           uint32 value length, key bytes, value bytes
+ */
+class MetadataStore
+{
+public:
+    enum class Table : uint8_t
+    {
+        TmdbArtwork = 1,
+        MalId = 2
+    };
+
+    struct Record
+    {
+        Table table;
+        std::string key;
+        std::string value;
+        std::chrono::system_clock::time_point expires;
+    };
+
+    using RecordVisitor = std::function<void(const Record &)>;
+
+    explicit MetadataStore(std::filesystem::path path);
+    ~MetadataStore();
+
+    /**
+     * @brief Reads every live record and opens the file for appending
+     *
+     * Calling load() again after a successful load is a no-op.
+     *
+     * @param visitor Invoked once per live (unexpired, latest) record
+     * @return true if the store is ready for appends
+     */
+    bool load(const RecordVisitor &visitor);
+
+    /**
+     * @brief Appends a record to the store
+     * @return true if the record was written
+     */
+    bool append(Table table, const std::string &key, const std::string &value,
+                std::chrono::system_clock::time_point expires);
+
+    /**
+     * @brief Flushes and closes the file; later appends are ignored until load() is called again
+     */
+    void close();
+
+private:
+    bool rewrite(const std::vector<Record> &records);
+    bool openForAppend();
+
+    std::filesystem::path m_path;
+    std::mutex m_mutex;
+    std::ofstream m_out;
+    bool m_loaded = false;
+};
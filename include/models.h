@@ -9,12 +9,6 @@
 #include <string>
 #include <vector>
 
-// Project headers
-#include "http_client.h"
-
-// Forward declarations
-class HttpClient;
-
 // Define the PlexServer struct
 struct PlexServer
 {
@@ -22,9 +16,9 @@ struct PlexServer
     std::string clientIdentifier;
     std::string localUri;
     std::string publicUri;
+    std::vector<std::string> uris; // Every advertised connection, local ones first
     std::string accessToken;
     std::chrono::system_clock::time_point lastUpdated;
-    std::unique_ptr<HttpClient> httpClient;
     std::atomic<bool> running;
     bool owned = false;
 };
@@ -71,6 +65,7 @@ struct MediaInfo
     std::string tmdbId;              // TMDB ID (if applicable)
     std::string tvdbId;              // TVDB ID (if applicable)
     std::string malId;               // MyAnimeList ID (if applicable)
+    std::string animeQuery;          // MyAnimeList search key (anime only)
 
     // TV Show specific
     std::string grandparentTitle; // Parent title (tv show name)
@@ -94,7 +89,17 @@ struct MediaInfo
     std::string sessionKey; // Plex session key
     std::string serverId;   // ID of the server hosting this content
 
-    MediaInfo() : state(PlaybackState::Stopped),
+    // Progressive enrichment: lookups still running when this info was published
+    bool artworkPending = false;                      // TMDB artwork not known yet
+    bool malIdPending = false;                        // MyAnimeList ID not known yet
+    std::chrono::steady_clock::time_point detectedAt; // When Plex first reported this media for the session
+
+    bool enrichmentPending() const { return artworkPending || malIdPending; }
+
+    MediaInfo() : year(0),
+                  season(0),
+                  episode(0),
+                  state(PlaybackState::Stopped),
                   progress(0),
                   duration(0),
                   startTime(0),
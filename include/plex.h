@@ -3,13 +3,19 @@
 // Standard library headers
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <future>
 #include <iomanip>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <random>
+#include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -27,16 +33,16 @@
 #include "config.h"
 #include "http_client.h"
 #include "logger.h"
+#include "lru_cache.h"
+#include "metadata_store.h"
 #include "models.h"
+#include "plex_sax.h"
+#include "scheduler.h"
+#include "single_flight.h"
+#include "sse_reactor.h"
+#include "thread_pool.h"
 #include "uuid.h"
 
-// Forward declarations for cache structures
-struct TMDBCacheEntry;
-struct MALCacheEntry;
-struct MediaCacheEntry;
-struct SessionUserCacheEntry;
-struct ServerUriCacheEntry;
-
 class Plex
 {
 public:
@@ -49,28 +55,68 @@ public:
 	// Get current playback status
 	MediaInfo getCurrentPlayback();
 
+	// Invoked (from a Plex thread) whenever the session returned by getCurrentPlayback changes
+	using PlaybackChangedCallback = std::function<void()>;
+	void setPlaybackChangedCallback(PlaybackChangedCallback callback);
+
 	// Stop all connections
 	void stop();
 
 private:
 	// Helper methods
 	std::map<std::string, std::string> getStandardHeaders(const std::string &token = "");
+	bool waitUnlessShuttingDown(std::chrono::milliseconds delay);
 
 	// State variables
 	std::atomic<bool> m_initialized;
 	std::atomic<bool> m_shuttingDown;
 
-	// Cache mutexes and maps
-	std::mutex m_cacheMutex;
-	std::map<std::string, TMDBCacheEntry> m_tmdbArtworkCache;
-	std::map<std::string, MALCacheEntry> m_malIdCache;
-	std::map<std::string, MediaCacheEntry> m_mediaInfoCache;
-	std::map<std::string, SessionUserCacheEntry> m_sessionUserCache;
-	std::map<std::string, ServerUriCacheEntry> m_serverUriCache;
-
-	// Active sessions
+	// Signalled by stop() so timed waits end early
+	std::mutex m_shutdownMutex;
+	std::condition_variable m_shutdownCv;
+
+	// Bounded TTL caches (thread-safe, LRU eviction)
+	LruCache<std::string, std::string> m_tmdbArtworkCache;
+	LruCache<std::string, std::string> m_malIdCache;
+	LruCache<std::string, MediaInfo> m_mediaInfoCache;
+	LruCache<std::string, std::string> m_sessionUserCache;
+	LruCache<std::string, std::string> m_serverUriCache;
+
+	// On-disk copy of the TMDB and MAL caches, loaded once on first init
+	MetadataStore m_metadataStore;
+	std::once_flag m_metadataStoreLoaded;
+
+	// Coalesce concurrent cache misses into a single upstream request per key
+	SingleFlight<std::string, MediaInfo> m_mediaFlight;
+	SingleFlight<std::string, nlohmann::json> m_grandparentFlight;
+	SingleFlight<std::string, std::string> m_tmdbFlight;
+	SingleFlight<std::string, std::string> m_malFlight;
+	SingleFlight<std::string, bool> m_sessionSnapshotFlight;
+
+	// Enrichment lookups queued or running ("tmdb:<id>", "mal:<query>")
+	std::mutex m_enrichmentMutex;
+	std::set<std::string> m_enrichmentInFlight;
+
+	// When each server's /status/sessions list was last fetched (debounces refreshes)
+	std::mutex m_sessionSnapshotMutex;
+	std::map<std::string, std::chrono::steady_clock::time_point> m_sessionSnapshotTimes;
+
+	// Active sessions (m_sessionMutex is never held across network I/O)
 	std::mutex m_sessionMutex;
 	std::map<std::string, MediaInfo> m_activeSessions;
+	std::map<std::string, uint64_t> m_sessionGenerations;
+	uint64_t m_sessionGeneration = 0;
+
+	// Change notification for the selected session
+	PlaybackChangedCallback m_playbackChangedCallback;
+	MediaInfo m_lastPublished;
+
+	// Runs the blocking HTTP work triggered by events, so the event loop only enqueues;
+	// declared before the reactor, whose callbacks post to it, so it is destroyed after
+	ThreadPool m_workPool;
+
+	// Shared event loop for every server's SSE notification stream
+	SSEReactor m_sseReactor;
 
 	// Authentication methods
 	bool acquireAuthToken();
@@ -90,12 +136,17 @@ private:
 	void setupServerSSEConnection(const std::shared_ptr<PlexServer> &server);
 
 	// Event handling methods
-	void handleSSEEvent(const std::string &serverId, const std::string &event);
+	void handleSSEEvent(const std::string &serverId, std::string_view event);
 	void processPlaySessionStateNotification(const std::string &serverId, const nlohmann::json &notification);
 	void updateSessionInfo(const std::string &serverId, const std::string &sessionKey,
 						   const std::string &state, const std::string &mediaKey,
-						   int64_t viewOffset, const std::shared_ptr<PlexServer> &server);
+						   int64_t viewOffset, const std::shared_ptr<PlexServer> &server,
+						   uint64_t generation, std::chrono::steady_clock::time_point receivedAt);
 	void updatePlaybackState(MediaInfo &info, const std::string &state, int64_t viewOffset);
+	MediaInfo selectCurrentSession();
+	void publishPlaybackIfChanged();
+	static bool isSamePlayback(const MediaInfo &a, const MediaInfo &b);
+	static bool isSameMedia(const MediaInfo &a, const MediaInfo &b);
 	std::string urlEncode(const std::string &value);
 
 	// Media info methods
@@ -109,11 +160,29 @@ private:
 	void parseGuid(const nlohmann::json &metadata, MediaInfo &info);
 	void parseGenres(const nlohmann::json &metadata, MediaInfo &info);
 	bool isAnimeContent(const nlohmann::json &metadata);
-	void fetchAnimeMetadata(const nlohmann::json &metadata, MediaInfo &info);
-	void fetchTMDBArtwork(const std::string &tmdbId, MediaInfo &info);
-	std::string fetchSessionUsername(const std::string &serverUri, const std::string &accessToken,
-									 const std::string &sessionKey);
+	// Return false on request or parse errors; true with an empty result means "none found"
+	bool fetchMALId(const std::string &query, std::string &malId);
+	bool fetchTMDBArtwork(const std::string &tmdbId, MediaType type, std::string &artPath);
+
+	// Third-party enrichment (TMDB artwork, MAL IDs), fetched concurrently after the basic info
+	bool applyCachedEnrichment(MediaInfo &info);
+	void requestEnrichment(const MediaInfo &info);
+	void postEnrichment(const std::string &host, const std::string &key, std::function<void()> lookup);
+	void applyEnrichmentToSessions();
+	void lookupTMDBArtwork(const std::string &tmdbId, MediaType type);
+	void lookupMALId(const std::string &query);
+	std::string resolveSessionUsername(const std::string &serverUri, const std::string &accessToken,
+									   const std::string &sessionKey);
+	bool refreshSessionSnapshot(const std::string &serverUri, const std::string &accessToken);
+	bool fetchSessionList(const std::string &serverUri, const std::string &accessToken,
+						  std::vector<SessionListExtractor::Session> &sessions);
+	void reconcileSessions(const std::string &serverId);
 	std::string getPreferredServerUri(const std::shared_ptr<PlexServer> &server);
+
+	// Persistent cache methods
+	void loadPersistentCache();
+	void persistCacheEntry(MetadataStore::Table table, const std::string &key, const std::string &value,
+						   std::chrono::seconds ttl);
 	void extractMusicSpecificInfo(const nlohmann::json &metadata, MediaInfo &info,
 								  const std::string &serverUri, const std::string &accessToken);
 };
\ No newline at end of file
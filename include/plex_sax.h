@@ -0,0 +1,139 @@
+#pragma once
+
+// Standard library headers
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Third-party headers
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Base SAX handler that tracks where the parser is inside a Plex response
+ *
+ * Plex wraps every payload as {"MediaContainer": {"Metadata": [ {...}, ... ]}}. The
+ * handler keeps a small stack of container frames so subclasses can tell whether a
+ * value belongs to a Metadata item, one of its child objects, or something to skip.
+ * Returning false from a callback stops the parse early.
+ */
+class PlexSaxHandler : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t &s) override;
+    bool string(string_t &val) override;
+    bool binary(binary_t &val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t &val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string &last_token,
+                     const nlohmann::detail::exception &ex) override;
+
+    const std::string &error() const { return m_error; }
+
+protected:
+    struct Frame
+    {
+        std::string key; // Key this container was stored under ("" for array elements and the root)
+        bool array;
+    };
+
+    // Depth of a Metadata item object: root, MediaContainer, Metadata array, item
+    static constexpr size_t ITEM_DEPTH = 4;
+
+    /**
+     * @brief Whether the innermost containers are MediaContainer.Metadata[n] (plus `extra` levels)
+     */
+    bool inMetadataItem(size_t extra = 0) const;
+
+    /**
+     * @brief Key of the container `levelsUp` levels above the current one ("" if none)
+     */
+    const std::string &parentKey(size_t levelsUp = 0) const;
+
+    // Hooks for subclasses; returning false stops parsing. Scalars are only materialised
+    // (and passed to onValue) when wantsValue() returns true for the current key.
+    virtual bool wantsValue() const = 0;
+    virtual bool onValue(nlohmann::json &&value) = 0;
+    virtual bool onObjectEnd() { return true; }
+
+    std::vector<Frame> m_stack;
+    std::string m_key; // Most recent key at the current level
+
+private:
+    bool beginContainer(bool array);
+    bool scalar(nlohmann::json &&value);
+
+    std::string m_error;
+};
+
+/**
+ * @brief Lists the sessions in a /status/sessions response
+ *
+ * Only the fields needed to track a session are materialised (its key, media key,
+ * view offset, player state and user); media parts, transcode details and the rest of
+ * the payload are skipped.
+ */
+class SessionListExtractor : public PlexSaxHandler
+{
+public:
+    struct Session
+    {
+        std::string sessionKey;
+        std::string mediaKey;
+        std::string state;
+        std::string username;
+        int64_t viewOffset = 0;
+    };
+
+    /**
+     * @param json Response body
+     * @param sessions Receives every session that has a session key
+     */
+    static void collect(const std::string &json, std::vector<Session> &sessions);
+
+private:
+    explicit SessionListExtractor(std::vector<Session> &sessions);
+
+    bool wantsValue() const override;
+    bool onValue(nlohmann::json &&value) override;
+    bool onObjectEnd() override;
+
+    std::vector<Session> &m_sessions;
+    Session m_item;
+};
+
+/**
+ * @brief Extracts the first item of a metadata response, keeping only what MediaInfo needs
+ *
+ * Produces a small JSON object with the item's scalar fields, Guid[].id and Genre[].tag;
+ * bulky children such as Media, Role or Director are skipped without being materialised,
+ * and parsing stops once the first item is complete.
+ */
+class MetadataExtractor : public PlexSaxHandler
+{
+public:
+    /**
+     * @param json Response body
+     * @param metadata Receives the pruned first Metadata item
+     * @return true if a Metadata item was found
+     */
+    static bool extractFirst(const std::string &json, nlohmann::json &metadata);
+
+private:
+    explicit MetadataExtractor(nlohmann::json &metadata);
+
+    bool wantsValue() const override;
+    bool onValue(nlohmann::json &&value) override;
+    bool onObjectEnd() override;
+
+    nlohmann::json &m_metadata;
+    nlohmann::json m_child;
+    bool m_found = false;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+/**
+ * @brief Reconnect backoff with decorrelated jitter
+ *
+ * Each delay is drawn uniformly from [base, 3 * previous delay] and capped, so retries
+ * back off roughly exponentially while clients that failed at the same moment (e.g.
+ * every stream after a router reboot) quickly drift apart instead of retrying in
+ * lockstep. reset() after a successful connection starts again from the base delay.
+ *
+ * Not thread-safe; each reconnecting component owns its own policy.
+ */
+class RetryPolicy
+{
+public:
+    /**
+     * @param base Smallest delay, also the first one after a reset
+     * @param cap Largest delay
+     */
+    RetryPolicy(std::chrono::milliseconds base, std::chrono::milliseconds cap)
+        : m_base(base), m_cap((std::max)(base, cap)), m_previous(base), m_random(std::random_device{}())
+    {
+    }
+
+    /**
+     * @brief Returns the delay before the next attempt and counts the attempt
+     */
+    std::chrono::milliseconds nextDelay()
+    {
+        std::uniform_int_distribution<long long> distribution(m_base.count(), (std::max)(m_base.count(), m_previous.count() * 3));
+        m_previous = (std::min)(m_cap, std::chrono::milliseconds(distribution(m_random)));
+        m_attempts++;
+        return m_previous;
+    }
+
+    /**
+     * @brief Forgets previous failures (call once a connection succeeds)
+     */
+    void reset()
+    {
+        m_previous = m_base;
+        m_attempts = 0;
+    }
+
+    /**
+     * @brief Number of delays handed out since the last reset
+     */
+    int attempts() const { return m_attempts; }
+
+private:
+    std::chrono::milliseconds m_base;
+    std::chrono::milliseconds m_cap;
+    std::chrono::milliseconds m_previous;
+    int m_attempts = 0;
+    std::mt19937_64 m_random;
+};
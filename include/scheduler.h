@@ -0,0 +1,123 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+// Project headers
+#include "logger.h"
+
+/**
+ * @brief Process-wide timer service running delayed tasks on a single thread
+ *
+ * Components schedule work for a deadline instead of keeping a thread asleep (or
+ * polling) until then. Timers live in a hierarchical timer wheel: four levels of 64
+ * slots with a 10 ms tick, each level 64 times coarser than the one below, so
+ * scheduling and cancelling are O(1) and timers cascade down a level as their
+ * deadline approaches. The timer thread sleeps until the next tick at which a slot
+ * actually has to be expired or cascaded, so an idle process does not wake at all and
+ * a process with only long timers wakes a handful of times per deadline.
+ *
+ * Tasks must be short: anything that does lengthy I/O should hand off to its owner's
+ * thread.
+ */
+class Scheduler
+{
+public:
+    using TaskId = uint64_t;
+    using Task = std::function<void()>;
+
+    struct Stats
+    {
+        uint64_t wakeups = 0; // Times the timer thread woke up
+        uint64_t fired = 0;   // Tasks run
+        size_t pending = 0;   // Tasks waiting for their deadline
+    };
+
+    static Scheduler &getInstance();
+
+    /**
+     * @brief Runs a task once after a delay (rounded up to the 10 ms tick)
+     * @return Id for cancel(); never 0, so 0 can mean "nothing scheduled"
+     */
+    TaskId schedule(std::chrono::milliseconds delay, Task task);
+
+    /**
+     * @brief Cancels a pending task
+     *
+     * If the task is running on the timer thread, waits for it to finish (unless called
+     * from the task itself), so captured objects can be destroyed safely afterwards.
+     *
+     * @return true if the task was cancelled before it ran
+     */
+    bool cancel(TaskId id);
+
+    /**
+     * @brief Stops the timer thread, dropping pending tasks
+     */
+    void shutdown();
+
+    /**
+     * @brief Returns wakeup and task counters
+     */
+    Stats stats() const;
+
+private:
+    Scheduler();
+    ~Scheduler();
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr uint64_t SLOTS = 1ull << SLOT_BITS;
+
+    struct Timer
+    {
+        TaskId id;
+        uint64_t expires; // Absolute tick
+        Task task;
+    };
+    using Slot = std::list<Timer>;
+
+    struct Location
+    {
+        Slot *slot;
+        Slot::iterator it;
+    };
+
+    void timerLoop();
+    uint64_t tickAt(Clock::time_point time, bool roundUp) const;
+    Clock::time_point timeOf(uint64_t tick) const;
+
+    // Wheel helpers (m_mutex held)
+    void place(Slot &from, Slot::iterator it);
+    void cascade(int level);
+    void runDue();
+    bool nextEventTick(uint64_t &tick) const;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_thread;
+    bool m_running = false;
+    TaskId m_nextId = 1;
+    TaskId m_runningId = 0;
+
+    Clock::time_point m_epoch;
+    uint64_t m_currentTick = 0;         // Last tick whose timers have been processed
+    uint64_t m_wakeTick = UINT64_MAX;   // Tick the timer thread is sleeping until
+    std::array<std::array<Slot, SLOTS>, LEVELS> m_wheel;
+    std::unordered_map<TaskId, Location> m_index;
+    Stats m_stats;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+// Standard library headers
+#include <exception>
+#include <future>
+#include <map>
+#include <mutex>
+
+/**
+ * @brief Coalesces concurrent calls for the same key into a single execution
+ *
+ * The first caller for a key runs the function; callers arriving while it is still
+ * in flight wait on the same shared future and receive the same result (or exception).
+ * Once the call completes the key is forgotten, so later calls run again.
+ */
+template <typename Key, typename Value>
+class SingleFlight
+{
+public:
+    /**
+     * @brief Runs func for key unless a call for key is already in flight
+     *
+     * @param key Key identifying the work
+     * @param func Callable returning Value
+     * @return The value produced by whichever call executed func
+     */
+    template <typename Func>
+    Value run(const Key &key, Func &&func)
+    {
+        std::promise<Value> promise;
+        std::shared_future<Value> future;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_inFlight.find(key);
+            if (it != m_inFlight.end())
+            {
+                future = it->second;
+            }
+            else
+            {
+                m_inFlight.emplace(key, promise.get_future().share());
+            }
+        }
+
+        if (future.valid())
+        {
+            // Someone else is already fetching this key
+            return future.get();
+        }
+
+        try
+        {
+            Value value = func();
+            promise.set_value(value);
+            forget(key);
+            return value;
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+            forget(key);
+            throw;
+        }
+    }
+
+private:
+    void forget(const Key &key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_inFlight.erase(key);
+    }
+
+    std::mutex m_mutex;
+    std::map<Key, std::shared_future<Value>> m_inFlight;
+};
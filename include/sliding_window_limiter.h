@@ -0,0 +1,72 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+
+/**
+ * @brief Sliding-window rate limiter: at most limit events in any window-long interval
+ *
+ * Keeps the times of the last limit events. An event is allowed once the oldest of
+ * them has left the window, so the exact moment the next one becomes possible is that
+ * event's time plus the window, which the owner can schedule for. Unlike a token
+ * bucket refilling at limit per window, a burst never lets more than limit events into
+ * a single window.
+ *
+ * Not thread-safe; the owner serializes access.
+ */
+class SlidingWindowLimiter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @param limit Most events allowed in one window
+     * @param window Length of the window
+     */
+    SlidingWindowLimiter(size_t limit, std::chrono::milliseconds window)
+        : m_limit((std::max)(limit, static_cast<size_t>(1))), m_window(window)
+    {
+    }
+
+    /**
+     * @brief Returns how long until an event is allowed (zero if one is allowed now)
+     */
+    Clock::duration timeUntilAvailable(Clock::time_point now) const
+    {
+        if (m_events.size() < m_limit)
+        {
+            return Clock::duration::zero();
+        }
+
+        Clock::time_point availableAt = m_events.front() + m_window;
+        return availableAt > now ? availableAt - now : Clock::duration::zero();
+    }
+
+    /**
+     * @brief Records an event; call only once timeUntilAvailable() returned zero
+     */
+    void record(Clock::time_point now)
+    {
+        m_events.push_back(now);
+        if (m_events.size() > m_limit)
+        {
+            m_events.pop_front();
+        }
+    }
+
+    /**
+     * @brief Forgets all recorded events
+     */
+    void reset()
+    {
+        m_events.clear();
+    }
+
+private:
+    size_t m_limit;
+    Clock::duration m_window;
+    std::deque<Clock::time_point> m_events; // Last limit events, oldest first
+};
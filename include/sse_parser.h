@@ -0,0 +1,94 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A Server-Sent Event as delivered to SSEParser's handler
+ *
+ * The views point into the parser's buffers and are only valid for the duration of the
+ * handler call; copy anything that has to outlive it.
+ */
+struct SSEEvent
+{
+    std::string_view type; // "message" unless the event set an event: field
+    std::string_view data; // data: lines joined with '\n'
+    std::string_view id;   // Last event ID in effect for this event
+};
+
+/**
+ * @brief Incremental parser for the text/event-stream format
+ *
+ * Implements the WHATWG event stream rules: CRLF, LF or CR line endings (also when a
+ * CRLF pair is split across chunks), comments, and the data/event/id/retry fields with
+ * multi-line data. Bytes are appended to a single buffer and only newly received bytes
+ * are scanned; consumed bytes are reclaimed by sliding the unconsumed tail to the front
+ * once it passes the middle of the buffer, so steady-state parsing does not allocate.
+ * Events with a single data line are handed out without copying the payload.
+ */
+class SSEParser
+{
+public:
+    using EventHandler = std::function<void(const SSEEvent &)>;
+
+    explicit SSEParser(EventHandler handler);
+
+    /**
+     * @brief Feeds a chunk of the response body, dispatching every completed event
+     */
+    void feed(const char *data, size_t size);
+
+    /**
+     * @brief Drops any partially received event (e.g. after a reconnect)
+     *
+     * The last event ID and retry value are kept, as the spec requires; an ID read
+     * for the dropped event is discarded with it.
+     */
+    void reset();
+
+    /**
+     * @brief ID of the last dispatched event (for the Last-Event-ID header)
+     */
+    const std::string &lastEventId() const { return m_lastEventId; }
+
+    /**
+     * @brief Reconnection time requested by the stream's retry: field, or -1 if none
+     */
+    long long retryMs() const { return m_retryMs; }
+
+private:
+    void processLine(size_t start, size_t end);
+    void dispatch();
+    void resetEvent();
+    void compact();
+    size_t findLineEnd(size_t from) const;
+
+    EventHandler m_handler;
+
+    // Received bytes [m_readPos, m_buffer.size()) are unconsumed; [m_scanPos, ...) are unscanned
+    std::vector<char> m_buffer;
+    size_t m_readPos = 0;
+    size_t m_scanPos = 0;
+    bool m_skipLeadingLF = false; // Previous chunk ended in CR; drop an LF that completes the CRLF
+    bool m_discarding = false;    // Current event overflowed; drop it up to the next blank line
+
+    // Fields of the event being assembled. A lone data line is kept as an offset into
+    // m_buffer (not copied); a second data line moves the data into m_data.
+    size_t m_dataLines = 0;
+    size_t m_dataOffset = 0;
+    size_t m_dataSize = 0;
+    std::string m_data;
+    std::string m_eventType;
+
+    // id: lines set the pending ID; it becomes the last event ID when the event is
+    // dispatched, so an event cut off by a dropped stream is not reported as received
+    std::string m_pendingEventId;
+    std::string m_lastEventId;
+    long long m_retryMs = -1;
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+// Standard library headers
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Third-party headers
+#include <curl/curl.h>
+
+// Project headers
+#include "logger.h"
+#include "retry_policy.h"
+#include "sse_parser.h"
+
+/**
+ * @brief Event loop multiplexing every Server-Sent Events (SSE) stream on one thread
+ *
+ * All streams share a single curl multi handle. On Linux the loop is driven by
+ * curl_multi_socket_action with an epoll set and an eventfd for wakeups; other
+ * platforms fall back to curl_multi_poll/curl_multi_wakeup. Either way the thread
+ * count stays constant no matter how many streams are registered, and stop()
+ * cancels every stream with a single wakeup.
+ */
+class SSEReactor
+{
+public:
+    SSEReactor();
+    ~SSEReactor();
+
+    // Callback type for SSE events (the event's views are only valid during the call)
+    using EventCallback = std::function<void(const SSEEvent &)>;
+
+    // Snapshot of one stream's health, for monitoring
+    struct StreamStatus
+    {
+        std::string id;
+        bool connected;
+        std::chrono::milliseconds lastByteAge; // Time since the last byte (or connection attempt)
+    };
+
+    // Callback type for a stream that came back after a disconnect (events may have been missed)
+    using ReconnectCallback = std::function<void()>;
+
+    /**
+     * @brief Starts the event loop thread (no-op if already running)
+     * @return true if the loop is running
+     */
+    bool start();
+
+    /**
+     * @brief Cancels every stream and stops the event loop thread
+     */
+    void stop();
+
+    /**
+     * @brief Registers a stream with the event loop
+     *
+     * The stream is reconnected automatically until it is removed or the reactor stops,
+     * backing off with jittered delays so streams that failed together retry apart.
+     * Reconnects send Last-Event-ID and honour the stream's retry: field. Registering
+     * an id that already exists replaces the previous stream.
+     *
+     * @param id Unique identifier of the stream (e.g. server client identifier)
+     * @param url SSE endpoint URL
+     * @param headers Request headers
+     * @param callback Invoked on the event loop thread for each event
+     * @param reconnectCallback Invoked on the event loop thread whenever the stream is
+     *                          re-established after a drop
+     * @return true if the stream was queued for connection
+     */
+    bool addStream(const std::string &id, const std::string &url,
+                   const std::map<std::string, std::string> &headers,
+                   EventCallback callback,
+                   ReconnectCallback reconnectCallback = nullptr);
+
+    /**
+     * @brief Disconnects and forgets a stream
+     * @param id Identifier passed to addStream
+     */
+    void removeStream(const std::string &id);
+
+    /**
+     * @brief Sets how long a connected stream may stay silent before it is considered dead
+     *
+     * Plex sends periodic pings, so silence beyond this window means a half-open
+     * connection; the stream is torn down and reconnected.
+     *
+     * @param timeout Idle window (zero disables the watchdog)
+     */
+    void setIdleTimeout(std::chrono::seconds timeout);
+
+    /**
+     * @brief Returns connection state and last-byte age of every stream
+     */
+    std::vector<StreamStatus> getStreamStatus() const;
+
+private:
+    struct Stream
+    {
+        std::string id;
+        std::string url;
+        std::map<std::string, std::string> headers;
+        EventCallback callback;
+        ReconnectCallback reconnectCallback;
+        CURL *easy = nullptr;
+        struct curl_slist *headerList = nullptr;
+        std::unique_ptr<SSEParser> parser;
+        bool active = false;
+        bool everConnected = false; // A previous connection got a 2xx response
+        RetryPolicy retry{std::chrono::seconds(1), std::chrono::seconds(60)};
+        std::chrono::steady_clock::time_point nextAttempt;
+        std::chrono::steady_clock::time_point lastByte;
+    };
+
+    // Event loop
+    void eventLoop();
+    void applyPendingChanges();
+    void connectDueStreams();
+    void processCompletedTransfers();
+    void checkIdleStreams();
+    int nextTimeoutMs() const;
+    void wakeup();
+
+    // Stream helpers (event loop thread only)
+    bool connectStream(Stream &stream);
+    void disconnectStream(Stream &stream);
+    void destroyStream(Stream &stream);
+    void scheduleReconnect(Stream &stream, bool failed);
+
+    // CURL callback functions
+    static size_t writeCallback(char *ptr, size_t size, size_t nmemb, void *userdata);
+    static size_t headerCallback(char *buffer, size_t size, size_t nitems, void *userdata);
+#ifdef __linux__
+    static int socketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp);
+    static int timerCallback(CURLM *multi, long timeout_ms, void *userp);
+#endif
+
+    CURLM *m_multi;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+
+    // Changes requested from other threads, applied by the event loop
+    // (a null stream means the id should be removed)
+    struct PendingChange
+    {
+        std::string id;
+        std::unique_ptr<Stream> stream;
+    };
+    std::mutex m_pendingMutex;
+    std::vector<PendingChange> m_pendingChanges;
+
+    // Owned by the event loop thread
+    std::map<std::string, std::unique_ptr<Stream>> m_streams;
+
+    // Idle watchdog window in seconds (0 = disabled)
+    std::atomic<long long> m_idleTimeoutSeconds;
+
+    // Stream health published by the event loop for getStreamStatus()
+    struct StatusEntry
+    {
+        bool connected;
+        std::chrono::steady_clock::time_point lastByte;
+    };
+    mutable std::mutex m_statusMutex;
+    std::map<std::string, StatusEntry> m_status;
+
+#ifdef __linux__
+    int m_epollFd;
+    int m_wakeFd;
+    std::set<curl_socket_t> m_watchedSockets;
+    bool m_curlTimerArmed = false;
+    std::chrono::steady_clock::time_point m_curlDeadline;
+#endif
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project headers
+#include "logger.h"
+
+/**
+ * @brief Bounded executor with per-host limits for blocking network work
+ *
+ * Posted tasks are spread round-robin over per-worker deques. Workers sleep on one
+ * shared condition variable and a shared count of queued tasks; a woken worker takes
+ * from the front of its own deque, or from the back of another one if its own is
+ * empty, so a task never waits behind a busy worker. Tasks are grouped by host and at
+ * most perHostLimit tasks of one host run at a time; further tasks for a saturated
+ * host wait in that host's queue without occupying a worker, so one slow API cannot
+ * starve the others. The total backlog is bounded and post() refuses work beyond it
+ * instead of growing without limit.
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param workers Number of worker threads
+     * @param perHostLimit Maximum tasks of one host running concurrently
+     * @param capacity Maximum tasks waiting to run (across all hosts)
+     */
+    ThreadPool(size_t workers, size_t perHostLimit, size_t capacity);
+    ~ThreadPool();
+
+    /**
+     * @brief Starts the worker threads (no-op if already running)
+     * @return true if the pool is running
+     */
+    bool start();
+
+    /**
+     * @brief Drops queued tasks and waits for running ones to finish
+     */
+    void stop();
+
+    /**
+     * @brief Queues a task
+     *
+     * @param host Concurrency group, normally the remote host the task talks to
+     * @param task Work to run on a worker thread
+     * @return false if the pool is stopped or the backlog is full
+     */
+    bool post(const std::string &host, Task task);
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    struct HostState
+    {
+        size_t active = 0;        // Tasks of this host handed to the workers
+        std::deque<Task> waiting; // Tasks held back by the per-host limit
+    };
+
+    void workerLoop(size_t index);
+    Task take(size_t index);
+    void dispatch(const std::string &host, Task task);
+    void finish(const std::string &host);
+
+    const size_t m_workerCount;
+    const size_t m_perHostLimit;
+    const size_t m_capacity;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<size_t> m_nextWorker{0};
+
+    // Tasks sitting in worker deques; workers sleep on m_wakeCv while it is zero
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    size_t m_queued = 0;
+    bool m_running = false;
+
+    // Per-host limits and the overall backlog (tasks posted but not yet started)
+    std::mutex m_hostMutex;
+    std::map<std::string, HostState> m_hosts;
+    size_t m_backlog = 0;
+};
@@ -18,6 +18,21 @@ void Application::setupLogging()
     LOG_INFO("Application", "Presence For Plex starting up");
 }
 
+void Application::requestPresenceUpdate(bool resend)
+{
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_playbackChanged = true;
+    m_resendPresence = m_resendPresence || resend;
+    m_wakeCv.notify_all();
+}
+
+void Application::setupPlexCallbacks()
+{
+    // Plex only calls this when the selected session actually changes
+    m_plex->setPlaybackChangedCallback([this]()
+                                       { requestPresenceUpdate(false); });
+}
+
 void Application::setupDiscordCallbacks()
 {
     m_discord->setConnectedCallback([this]()
@@ -32,8 +47,9 @@ void Application::setupDiscordCallbacks()
         }
 #endif
         m_plex->init();
-        std::unique_lock<std::mutex> lock(m_discordConnectMutex);
-        m_discordConnectCv.notify_all();
+
+        // A fresh Discord connection has no presence yet, so push the current one
+        requestPresenceUpdate(true);
                                     });
 
         m_discord->setDisconnectedCallback([this]()
@@ -65,6 +81,7 @@ bool Application::initialize()
         m_trayIcon->show();
 #endif
 
+        setupPlexCallbacks();
         setupDiscordCallbacks();
 
         m_discord->start();
@@ -226,8 +243,17 @@ void Application::processPlaybackInfo(const MediaInfo &info)
             LOG_DEBUG("Application", "Playback state changed, updating Discord presence to " + std::to_string(static_cast<int>(info.state)));
             m_discord->updatePresence(info);
         }
+        else if (info.artPath != m_lastArtPath || info.malId != m_lastMalId ||
+                 info.enrichmentPending() != m_lastEnrichmentPending)
+        {
+            LOG_DEBUG("Application", "Media enrichment arrived, updating Discord presence");
+            m_discord->updatePresence(info);
+        }
         m_lastStartTime = info.startTime;
         m_lastState = info.state;
+        m_lastArtPath = info.artPath;
+        m_lastMalId = info.malId;
+        m_lastEnrichmentPending = info.enrichmentPending();
     }
     else if (info.state == PlaybackState::NotInitialized)
     {
@@ -249,21 +275,33 @@ void Application::run()
 
     while (m_running)
     {
+        bool resend = false;
+        {
+            // Sleep until Plex reports a change, Discord connects, or we are asked to stop
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCv.wait(lock, [this]()
+                          { return m_playbackChanged || !m_running; });
+
+            if (!m_running)
+            {
+                break;
+            }
+
+            m_playbackChanged = false;
+            std::swap(resend, m_resendPresence);
+        }
+
         try
         {
+            // The connected callback requests a resend once Discord is back
             if (!m_discord->isConnected())
             {
-                std::unique_lock<std::mutex> lock(m_discordConnectMutex);
-                // Reduce wait time to be more responsive to shutdown
-                m_discordConnectCv.wait_for(lock,
-                                            std::chrono::milliseconds(500),
-                                            [this]()
-                                            { return m_discord->isConnected() || !m_running; });
-
-                if (!m_running || !m_discord->isConnected())
-                {
-                    continue;
-                }
+                continue;
+            }
+
+            if (resend)
+            {
+                m_lastState = PlaybackState::NotInitialized;
             }
 
             MediaInfo info = m_plex->getCurrentPlayback();
@@ -275,8 +313,6 @@ void Application::run()
         {
             LOG_ERROR("Application", "Error in main loop: " + std::string(e.what()));
         }
-
-        std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 
     performCleanup();
@@ -358,7 +394,7 @@ void Application::stop()
     // Set running to false and wake up any waiting threads
     m_running = false;
 
-    // Wake up thread waiting for Discord connection if we're in that state
-    std::unique_lock<std::mutex> lock(m_discordConnectMutex);
-    m_discordConnectCv.notify_all();
+    // Wake up the main loop so it can exit
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeCv.notify_all();
 }
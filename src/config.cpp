@@ -127,6 +127,8 @@ void Config::loadFromYaml(const YAML::Node &config)
 {
     // General settings
     logLevel = config["log_level"] ? config["log_level"].as<int>() : 1;
+    persistentCache = config["persistent_cache"] ? config["persistent_cache"].as<bool>() : true;
+    sseIdleTimeout = config["sse_idle_timeout"] ? config["sse_idle_timeout"].as<int>() : 90;
 
     // Plex auth
     if (config["plex"])
@@ -149,6 +151,11 @@ void Config::loadFromYaml(const YAML::Node &config)
             std::string publicUri = server["public_uri"] ? server["public_uri"].as<std::string>() : "";
             std::string accessToken = server["access_token"] ? server["access_token"].as<std::string>() : "";
             bool owned = server["owned"] ? server["owned"].as<bool>() : false;
+            std::vector<std::string> uris;
+            if (server["uris"] && server["uris"].IsSequence())
+            {
+                uris = server["uris"].as<std::vector<std::string>>();
+            }
 
             auto serverPtr = std::make_shared<PlexServer>();
             serverPtr->name = name;
@@ -157,6 +164,7 @@ void Config::loadFromYaml(const YAML::Node &config)
             serverPtr->publicUri = publicUri;
             serverPtr->accessToken = accessToken;
             serverPtr->owned = owned;
+            serverPtr->uris = uris;
 
             plexServers[clientId] = serverPtr;
         }
@@ -203,6 +211,8 @@ YAML::Node Config::saveToYaml() const
 
     // General settings
     config["log_level"] = logLevel.load();
+    config["persistent_cache"] = persistentCache.load();
+    config["sse_idle_timeout"] = sseIdleTimeout.load();
 
     // Plex auth
     YAML::Node plex;
@@ -222,6 +232,10 @@ YAML::Node Config::saveToYaml() const
         serverNode["public_uri"] = server->publicUri;
         serverNode["access_token"] = server->accessToken;
         serverNode["owned"] = server->owned;
+        if (!server->uris.empty())
+        {
+            serverNode["uris"] = server->uris;
+        }
         servers.push_back(serverNode);
     }
     config["plex_servers"] = servers;
@@ -256,6 +270,26 @@ void Config::setLogLevel(int level)
     logLevel.store(level);
 }
 
+bool Config::getPersistentCacheEnabled() const
+{
+    return persistentCache.load();
+}
+
+void Config::setPersistentCacheEnabled(bool enabled)
+{
+    persistentCache.store(enabled);
+}
+
+int Config::getSSEIdleTimeout() const
+{
+    return sseIdleTimeout.load();
+}
+
+void Config::setSSEIdleTimeout(int seconds)
+{
+    sseIdleTimeout.store(seconds);
+}
+
 // Plex settings
 std::string Config::getPlexAuthToken() const
 {
@@ -301,7 +335,8 @@ const std::map<std::string, std::shared_ptr<PlexServer>> &Config::getPlexServers
 
 void Config::addPlexServer(const std::string &name, const std::string &clientId,
                            const std::string &localUri, const std::string &publicUri,
-                           const std::string &accessToken, bool owned)
+                           const std::string &accessToken, bool owned,
+                           const std::vector<std::string> &uris)
 {
     std::unique_lock lock(mutex);
 
@@ -315,6 +350,7 @@ void Config::addPlexServer(const std::string &name, const std::string &clientId,
         it->second->publicUri = publicUri;
         it->second->accessToken = accessToken;
         it->second->owned = owned;
+        it->second->uris = uris;
         return;
     }
 
@@ -326,6 +362,7 @@ void Config::addPlexServer(const std::string &name, const std::string &clientId,
     server->publicUri = publicUri;
     server->accessToken = accessToken;
     server->owned = owned;
+    server->uris = uris;
     plexServers[clientId] = server;
 }
 
@@ -4,24 +4,58 @@ constexpr int MAX_PAUSED_DURATION = 9999;
 
 // Rate limit constants chosen based on how Music Presence does it - kind of...
 // I can't find anything online about Discord's rate limits, but there is definitely something
-constexpr int MAX_FRAMES_PER_WINDOW = 5;
-constexpr int RATE_LIMIT_WINDOW_SECONDS = 15;
-constexpr int MIN_FRAME_INTERVAL_SECONDS = 1;
-constexpr int MAX_FRAMES_SHORT_WINDOW = 3;
-constexpr int RATE_LIMIT_SHORT_WINDOW = 5;
+// Sustained rate: at most 4 frames in any 15 seconds
+constexpr size_t LONG_WINDOW_FRAMES = 4;
+constexpr std::chrono::milliseconds LONG_WINDOW(15000);
+// Short-term rate: at most 2 frames in any 5 seconds
+constexpr size_t SHORT_WINDOW_FRAMES = 2;
+constexpr std::chrono::milliseconds SHORT_WINDOW(5000);
+constexpr std::chrono::milliseconds MIN_FRAME_INTERVAL(1000);
+
+// Without a recent write the health check pings Discord
+constexpr std::chrono::seconds PING_IDLE_INTERVAL(60);
+
+// How long a health check waits for Discord to answer a ping
+constexpr std::chrono::seconds PONG_TIMEOUT(5);
+
+// Reconnect backoff (decorrelated jitter between these bounds) and health check period
+constexpr std::chrono::milliseconds RECONNECT_BASE_DELAY(2000);
+constexpr std::chrono::milliseconds RECONNECT_MAX_DELAY(60000);
+constexpr std::chrono::milliseconds HEALTH_CHECK_INTERVAL(60000);
+
+// Playback start drift (seconds) below which two presences count as identical
+constexpr int64_t PRESENCE_START_TOLERANCE_SECONDS = 5;
+
+// Fingerprint hash of a cleared presence (0 is reserved for "unknown")
+constexpr uint64_t CLEARED_PRESENCE_HASH = 1;
+
+// FNV-1a parameters, so fingerprints don't depend on the standard library's std::hash
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
 
 using json = nlohmann::json;
 
 Discord::Discord() : running(false),
-					 needs_reconnect(false),
-					 reconnect_attempts(0),
 					 is_playing(false),
 					 nonce_counter(0),
 					 onConnected(nullptr),
 					 onDisconnected(nullptr),
 					 has_queued_frame(false),
-					 last_frame_write_time(0)
+					 last_frame_write_time(),
+					 flush_timer(0),
+					 flush_running(false),
+					 frames_sent(0),
+					 frames_suppressed(0),
+					 queued_complete(false),
+					 work_due(false),
+					 connection_lost(false),
+					 work_timer(0),
+					 retry_policy(RECONNECT_BASE_DELAY, RECONNECT_MAX_DELAY),
+					 short_window(SHORT_WINDOW_FRAMES, SHORT_WINDOW),
+					 long_window(LONG_WINDOW_FRAMES, LONG_WINDOW)
 {
+	ipc.setClosedCallback([this]()
+						  { connectionLost(); });
 }
 
 Discord::~Discord()
@@ -34,51 +68,68 @@ Discord::~Discord()
 void Discord::connectionThread()
 {
 	LOG_INFO("Discord", "Connection thread started");
-	while (running)
+	requestWork();
+
+	while (true)
 	{
-		// Handle connection logic
-		if (!ipc.isConnected())
+		bool lost;
 		{
-			LOG_DEBUG("Discord", "Not connected, attempting connection");
+			// Nothing to do until a scheduler timer (or a failed write) wakes us
+			std::unique_lock<std::mutex> lock(work_mutex);
+			work_cv.wait(lock, [this]()
+						 { return !running || work_due; });
+			if (!running)
+			{
+				break;
+			}
+			work_due = false;
+			lost = connection_lost;
+			connection_lost = false;
+		}
 
-			// Calculate exponential backoff delay
-			if (reconnect_attempts > 0)
+		if (lost)
+		{
+			LOG_INFO("Discord", "Connection to Discord lost, will reconnect");
+			ipc.closePipe();
+
+			// Call disconnected callback if set
+			if (onDisconnected)
 			{
-				int delay = std::min(5 * reconnect_attempts, 60);
-				LOG_INFO("Discord", "Reconnection attempt " + std::to_string(reconnect_attempts) +
-										", waiting " + std::to_string(delay) + " seconds");
-
-				for (int i = 0; i < delay * 2 && running; ++i)
-				{
-					std::this_thread::sleep_for(std::chrono::milliseconds(500));
-					if (i % 10 == 0)
-					{
-						processQueuedFrame(); // Process frames more frequently during wait
-					}
-				}
-				if (!running)
-				{
-					break;
-				}
+				onDisconnected();
 			}
+		}
 
-			reconnect_attempts++;
+		// Handle connection logic
+		if (!ipc.isConnected())
+		{
+			LOG_DEBUG("Discord", "Not connected, attempting connection");
 
 			// Attempt to connect
 			if (!attemptConnection())
 			{
-				LOG_INFO("Discord", "Failed to connect to Discord IPC, will retry later");
+				auto delay = retry_policy.nextDelay();
+				LOG_INFO("Discord", "Failed to connect to Discord IPC, reconnection attempt " +
+										std::to_string(retry_policy.attempts()) + " in " +
+										std::to_string(delay.count()) + " ms");
+				scheduleWork(delay);
 				continue;
 			}
 
-			reconnect_attempts = 0;
+			retry_policy.reset();
 			LOG_INFO("Discord", "Successfully connected to Discord");
 
+			// A new connection starts without any presence
+			{
+				std::lock_guard<std::mutex> lock(frame_queue_mutex);
+				acked_fingerprint = PresenceFingerprint();
+			}
+
 			// Call connected callback if set
 			if (onConnected)
 			{
 				onConnected();
 			}
+			scheduleWork(HEALTH_CHECK_INTERVAL);
 		}
 		else
 		{
@@ -86,38 +137,41 @@ void Discord::connectionThread()
 
 			if (!isStillAlive())
 			{
-				LOG_INFO("Discord", "Connection to Discord lost, will reconnect");
-				if (ipc.isConnected())
-				{
-					ipc.closePipe();
-				}
-				needs_reconnect = true;
-
-				// Call disconnected callback if set
-				if (onDisconnected)
-				{
-					onDisconnected();
-				}
+				// First reconnect is immediate; backoff only starts once it fails
+				connectionLost();
 				continue;
 			}
-			else
-			{
-				needs_reconnect = false;
-			}
 
-			// Connection health check sleep
-			for (int i = 0; i < 600 && running && !needs_reconnect; ++i) // 600 * 100ms = 60s
-			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(100));
-				if (i % 10 == 0)
-				{
-					processQueuedFrame();
-				}
-			}
+			scheduleWork(HEALTH_CHECK_INTERVAL);
 		}
 	}
 }
 
+void Discord::scheduleWork(std::chrono::milliseconds delay)
+{
+	if (work_timer)
+	{
+		Scheduler::getInstance().cancel(work_timer);
+	}
+	work_timer = Scheduler::getInstance().schedule(delay, [this]()
+												   { requestWork(); });
+}
+
+void Discord::requestWork()
+{
+	std::lock_guard<std::mutex> lock(work_mutex);
+	work_due = true;
+	work_cv.notify_all();
+}
+
+void Discord::connectionLost()
+{
+	std::lock_guard<std::mutex> lock(work_mutex);
+	connection_lost = true;
+	work_due = true;
+	work_cv.notify_all();
+}
+
 bool Discord::attemptConnection()
 {
 	if (!ipc.openPipe())
@@ -136,14 +190,14 @@ bool Discord::attemptConnection()
 	}
 
 	int opcode;
-	std::string response;
+	std::string_view response;
 	LOG_DEBUG("Discord", "Waiting for handshake response");
 	if (!ipc.readFrame(opcode, response) || opcode != OP_FRAME)
 	{
 		LOG_ERROR("Discord", "Failed to read handshake response. Opcode: " + std::to_string(opcode));
 		if (!response.empty())
 		{
-			LOG_DEBUG("Discord", "Response content: " + response);
+			LOG_DEBUG("Discord", "Response content: " + std::string(response));
 		}
 		ipc.closePipe();
 		return false;
@@ -153,13 +207,13 @@ bool Discord::attemptConnection()
 
 	try
 	{
-		LOG_DEBUG("Discord", "Parsing response: " + response);
-		json ready = json::parse(response);
+		LOG_DEBUG("Discord", "Parsing response: " + std::string(response));
+		json ready = json::parse(response.begin(), response.end());
 
 		if (!ready.contains("evt"))
 		{
 			LOG_ERROR("Discord", "Discord response missing 'evt' field");
-			LOG_DEBUG("Discord", "Complete response: " + response);
+			LOG_DEBUG("Discord", "Complete response: " + std::string(response));
 			ipc.closePipe();
 			return false;
 		}
@@ -171,6 +225,9 @@ bool Discord::attemptConnection()
 			return false;
 		}
 		LOG_DEBUG("Discord", "Handshake READY event confirmed");
+
+		// From here on replies are routed by the reader thread
+		ipc.startReader();
 		return true;
 	}
 	catch (const json::parse_error &e)
@@ -186,7 +243,7 @@ bool Discord::attemptConnection()
 	catch (const std::exception &e)
 	{
 		LOG_ERROR("Discord", "Failed to parse READY response: " + std::string(e.what()));
-		LOG_DEBUG("Discord", "Response that caused the error: " + response);
+		LOG_DEBUG("Discord", "Response that caused the error: " + std::string(response));
 	}
 
 	ipc.closePipe();
@@ -215,6 +272,17 @@ void Discord::updatePresence(const MediaInfo &info)
 
 		is_playing = true;
 
+		// Identical to what Discord already shows: don't spend a frame on it
+		PresenceFingerprint fingerprint = fingerprintFor(info);
+		if (suppressIfShown(fingerprint))
+		{
+			if (!info.enrichmentPending())
+			{
+				logFrameTiming(info.detectedAt, true);
+			}
+			return;
+		}
+
 		std::string nonce = generateNonce();
 		std::string presence = createPresence(info, nonce);
 
@@ -222,8 +290,9 @@ void Discord::updatePresence(const MediaInfo &info)
 															   << (info.state == PlaybackState::Paused ? " (Paused)" : "")
 															   << (info.state == PlaybackState::Buffering ? " (Buffering)" : ""));
 
-		// Queue the presence update
-		queuePresenceMessage(presence);
+		// Queue the presence update; if an earlier (less enriched) frame for this media is
+		// still waiting on the rate limiter, this one replaces it
+		queuePresenceMessage(presence, nonce, fingerprint, &info);
 
 		// Attempt to send it immediately
 		processQueuedFrame();
@@ -239,6 +308,69 @@ void Discord::updatePresence(const MediaInfo &info)
 	}
 }
 
+Discord::PresenceFingerprint Discord::fingerprintFor(const MediaInfo &info)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	auto mix = [&hash](const std::string &field)
+	{
+		for (unsigned char c : field)
+		{
+			hash = (hash ^ c) * FNV_PRIME;
+		}
+		// Field separator, so ("ab", "c") and ("a", "bc") differ
+		hash = (hash ^ 0x1F) * FNV_PRIME;
+	};
+
+	// Everything createActivity() renders; pending flags only matter through the fields they gate
+	mix(std::to_string(static_cast<int>(info.state)));
+	mix(std::to_string(static_cast<int>(info.type)));
+	mix(info.title);
+	mix(std::to_string(info.year));
+	mix(info.grandparentTitle);
+	mix(std::to_string(info.season));
+	mix(std::to_string(info.episode));
+	mix(info.artist);
+	mix(info.album);
+	for (const auto &genre : info.genres)
+	{
+		mix(genre);
+	}
+	mix(info.artPath);
+	mix(info.malId);
+	mix(info.imdbId);
+	mix(std::to_string(static_cast<int64_t>(info.duration)));
+
+	PresenceFingerprint fingerprint;
+	fingerprint.hash = hash <= CLEARED_PRESENCE_HASH ? hash + 2 : hash;
+
+	// Only a playing presence shows a live progress bar (start = now - progress, as in
+	// createActivity()); paused ones sit at a fixed far-future offset
+	if (info.state == PlaybackState::Playing)
+	{
+		int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+						  std::chrono::system_clock::now().time_since_epoch())
+						  .count();
+		fingerprint.start_time = now - static_cast<int64_t>(info.progress);
+	}
+	return fingerprint;
+}
+
+bool Discord::suppressIfShown(const PresenceFingerprint &fingerprint)
+{
+	std::lock_guard<std::mutex> lock(frame_queue_mutex);
+	if (acked_fingerprint.hash == 0 || fingerprint.hash != acked_fingerprint.hash ||
+		std::abs(fingerprint.start_time - acked_fingerprint.start_time) > PRESENCE_START_TOLERANCE_SECONDS)
+	{
+		return false;
+	}
+
+	has_queued_frame = false;
+	frames_suppressed++;
+	LOG_DEBUG("Discord", "Suppressed redundant presence frame (sent: " + std::to_string(frames_sent) +
+							 ", suppressed: " + std::to_string(frames_suppressed) + ")");
+	return true;
+}
+
 bool Discord::isConnected() const
 {
 	return ipc.isConnected();
@@ -288,13 +420,17 @@ json Discord::createActivity(const MediaInfo &info)
 	json assets = {};
 	int activityType = 3; // Default: Watching
 
-	// Default large image
+	// Default large image, also the placeholder while artwork is still being looked up
 	assets["large_image"] = "plex_logo";
 
 	if (!info.artPath.empty())
 	{
 		assets["large_image"] = info.artPath;
 	}
+	else if (info.artworkPending)
+	{
+		LOG_DEBUG("Discord", "Artwork pending, using placeholder image");
+	}
 
 	if (info.type == MediaType::TVShow)
 	{
@@ -393,7 +529,8 @@ json Discord::createActivity(const MediaInfo &info)
 
 	json buttons = {};
 
-	// Add relevant buttons based on available IDs
+	// Add relevant buttons based on available IDs. While the MAL lookup is pending the
+	// IMDb button stands in; the enriched update swaps it for the MAL one.
 	if (!info.malId.empty())
 	{
 		buttons.push_back({{"label", "View on MyAnimeList"},
@@ -427,30 +564,35 @@ json Discord::createActivity(const MediaInfo &info)
 	return ret;
 }
 
-void Discord::sendPresenceMessage(const std::string &message)
+bool Discord::sendPresenceMessage(const std::string &message, const std::string &nonce,
+								  const PresenceFingerprint &fingerprint)
 {
-	if (!ipc.writeFrame(OP_FRAME, message))
+	// Fire and forget: Discord's reply arrives later on the IPC reader thread
+	bool written = ipc.sendRequest(nonce, message, [this, nonce, fingerprint](const DiscordIPC::Reply &reply)
+								   { onPresenceReply(reply, nonce, fingerprint); });
+	if (!written)
 	{
 		LOG_WARNING("Discord", "Failed to send presence update");
-		needs_reconnect = true;
-		// Call disconnected callback if set
-		if (onDisconnected)
-		{
-			onDisconnected();
-		}
-		return;
 	}
+	return written;
+}
 
-	int opcode;
-	std::string response;
-	if (ipc.readFrame(opcode, response))
+void Discord::onPresenceReply(const DiscordIPC::Reply &reply, const std::string &nonce,
+							  const PresenceFingerprint &fingerprint)
+{
+	bool acknowledged = false;
+	if (reply.ok)
 	{
 		try
 		{
-			json response_json = json::parse(response);
+			json response_json = json::parse(reply.data);
 			if (response_json.contains("evt") && response_json["evt"] == "ERROR")
 			{
-				LOG_WARNING_STREAM("Discord", "Discord rejected presence update: " << response);
+				LOG_WARNING_STREAM("Discord", "Discord rejected presence update: " << reply.data);
+			}
+			else
+			{
+				acknowledged = true;
 			}
 		}
 		catch (const std::exception &e)
@@ -460,21 +602,38 @@ void Discord::sendPresenceMessage(const std::string &message)
 	}
 	else
 	{
-		LOG_WARNING("Discord", "Failed to read Discord response");
+		LOG_WARNING("Discord", "Connection closed before Discord answered presence update");
+	}
+
+	// Only the newest frame's answer says what is on screen
+	std::lock_guard<std::mutex> lock(frame_queue_mutex);
+	if (nonce == inflight_nonce)
+	{
+		acked_fingerprint = acknowledged ? fingerprint : PresenceFingerprint();
 	}
 }
 
-void Discord::queuePresenceMessage(const std::string &message)
+void Discord::queuePresenceMessage(const std::string &message, const std::string &nonce,
+								   const PresenceFingerprint &fingerprint, const MediaInfo *info)
 {
 	std::lock_guard<std::mutex> lock(frame_queue_mutex);
 	queued_frame = message;
+	queued_nonce = nonce;
+	queued_fingerprint = fingerprint;
 	has_queued_frame = true;
+	queued_detected_at = info ? info->detectedAt : std::chrono::steady_clock::time_point();
+	queued_complete = info && !info->enrichmentPending();
 	LOG_DEBUG("Discord", "Frame queued for sending");
+	scheduleFlush(std::chrono::milliseconds(0));
 }
 
 void Discord::processQueuedFrame()
 {
 	std::string frame_to_send;
+	std::string nonce;
+	PresenceFingerprint fingerprint;
+	std::chrono::steady_clock::time_point detected_at;
+	bool complete;
 
 	{
 		std::lock_guard<std::mutex> lock(frame_queue_mutex);
@@ -483,65 +642,104 @@ void Discord::processQueuedFrame()
 			return;
 		}
 
+		// Rate limited: flush again at the exact moment the frame becomes sendable
 		auto now = std::chrono::steady_clock::now();
-		auto now_seconds = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
-
-		// Check rate limits
-		if (!canSendFrame(now_seconds))
+		auto delay = frameDelay(now);
+		if (delay > std::chrono::steady_clock::duration::zero())
 		{
+			auto delay_ms = std::chrono::ceil<std::chrono::milliseconds>(delay);
+			LOG_DEBUG("Discord", "Rate limit: frame deferred by " + std::to_string(delay_ms.count()) + " ms");
+			scheduleFlush(delay_ms);
 			return;
 		}
 
 		frame_to_send = queued_frame;
+		nonce = queued_nonce;
+		fingerprint = queued_fingerprint;
 		has_queued_frame = false;
+		detected_at = queued_detected_at;
+		complete = queued_complete;
+
+		// Record this frame write
+		short_window.record(now);
+		long_window.record(now);
+		last_frame_write_time = now;
 
-		// Record this frame write time
-		frame_write_times.push_back(now_seconds);
-		last_frame_write_time = now_seconds;
+		// Until Discord answers, what is on screen is unknown
+		acked_fingerprint = PresenceFingerprint();
+		inflight_nonce = nonce;
+		frames_sent++;
 	}
 
 	LOG_DEBUG("Discord", "Processing queued frame");
-	sendPresenceMessage(frame_to_send);
+	sendPresenceMessage(frame_to_send, nonce, fingerprint);
+	logFrameTiming(detected_at, complete);
 }
 
-bool Discord::canSendFrame(int64_t current_time)
+void Discord::logFrameTiming(std::chrono::steady_clock::time_point detected_at, bool complete)
 {
-	// Enforce minimum interval between frames
-	if (current_time - last_frame_write_time < MIN_FRAME_INTERVAL_SECONDS)
+	if (detected_at == std::chrono::steady_clock::time_point())
 	{
-		LOG_DEBUG("Discord", "Rate limit: Too soon since last frame");
-		return false;
+		return;
 	}
 
-	while (!frame_write_times.empty() &&
-		   frame_write_times.front() < current_time - RATE_LIMIT_WINDOW_SECONDS)
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+					   std::chrono::steady_clock::now() - detected_at)
+					   .count();
+
+	std::lock_guard<std::mutex> lock(frame_queue_mutex);
+	if (first_frame_logged != detected_at)
 	{
-		frame_write_times.pop_front();
+		first_frame_logged = detected_at;
+		LOG_INFO("Discord", "Time to first presence frame: " + std::to_string(elapsed) + " ms" +
+								(complete ? " (fully enriched)" : ""));
 	}
-
-	// Check if we've reached the maximum frames per long window (15 seconds)
-	if (frame_write_times.size() >= MAX_FRAMES_PER_WINDOW - 1)
+	if (complete && full_frame_logged != detected_at)
 	{
-		LOG_DEBUG("Discord", "Rate limit: Maximum frames per 15-second window reached");
-		return false;
+		full_frame_logged = detected_at;
+		LOG_INFO("Discord", "Time to full presence frame: " + std::to_string(elapsed) + " ms");
 	}
+}
 
-	int frames_in_short_window = 0;
-	for (const auto &timestamp : frame_write_times)
+void Discord::scheduleFlush(std::chrono::milliseconds delay)
+{
+	if (flush_timer || !running)
 	{
-		if (timestamp >= current_time - RATE_LIMIT_SHORT_WINDOW)
+		return;
+	}
+
+	flush_timer = Scheduler::getInstance().schedule(delay, [this]()
+													{
 		{
-			frames_in_short_window++;
+			std::lock_guard<std::mutex> lock(frame_queue_mutex);
+			flush_timer = 0;
+			flush_running = true;
 		}
-	}
+		processQueuedFrame();
+		{
+			std::lock_guard<std::mutex> lock(frame_queue_mutex);
+			flush_running = false;
+		}
+		flush_cv.notify_all(); });
+}
 
-	if (frames_in_short_window >= MAX_FRAMES_SHORT_WINDOW - 1)
+std::chrono::steady_clock::duration Discord::frameDelay(std::chrono::steady_clock::time_point now) const
+{
+	// Enforce minimum interval between frames
+	auto delay = std::chrono::steady_clock::duration::zero();
+	if (last_frame_write_time != std::chrono::steady_clock::time_point())
 	{
-		LOG_DEBUG("Discord", "Rate limit: Maximum frames per 5-second window reached");
-		return false;
+		auto next_allowed = last_frame_write_time + MIN_FRAME_INTERVAL;
+		if (next_allowed > now)
+		{
+			delay = next_allowed - now;
+		}
 	}
 
-	return true;
+	// Both windows must have room, so wait for whichever frees up last
+	delay = (std::max)(delay, short_window.timeUntilAvailable(now));
+	delay = (std::max)(delay, long_window.timeUntilAvailable(now));
+	return delay;
 }
 
 void Discord::clearPresence()
@@ -555,58 +753,56 @@ void Discord::clearPresence()
 
 	is_playing = false;
 
+	PresenceFingerprint fingerprint;
+	fingerprint.hash = CLEARED_PRESENCE_HASH;
+	if (suppressIfShown(fingerprint))
+	{
+		return;
+	}
+
 #ifdef _WIN32
 	auto process_id = static_cast<int>(GetCurrentProcessId());
 #else
 	auto process_id = static_cast<int>(getpid());
 #endif
 	// Create empty presence payload to clear current presence
+	std::string nonce = generateNonce();
 	json presence = {
 		{"cmd", "SET_ACTIVITY"},
 		{"args", {{"pid", process_id}, {"activity", nullptr}}},
-		{"nonce", generateNonce()}};
+		{"nonce", nonce}};
 
 	std::string presence_str = presence.dump();
 
 	// Queue the clear presence message instead of sending immediately
-	queuePresenceMessage(presence_str);
+	queuePresenceMessage(presence_str, nonce, fingerprint);
 }
 
 bool Discord::isStillAlive()
 {
 
-	// Get current time
-	auto now = std::chrono::duration_cast<std::chrono::seconds>(
-				   std::chrono::steady_clock::now().time_since_epoch())
-				   .count();
-
 	// Skip ping if there was a recent write
-	if (now - last_frame_write_time < 60)
+	std::chrono::steady_clock::time_point last_write;
+	{
+		std::lock_guard<std::mutex> lock(frame_queue_mutex);
+		last_write = last_frame_write_time;
+	}
+	if (std::chrono::steady_clock::now() - last_write < PING_IDLE_INTERVAL)
 	{
 		LOG_DEBUG("Discord", "Skipping ping due to recent write activity");
 		return true;
 	}
 
-	if (!ipc.sendPing())
+	// The reader thread hands us the PONG; other traffic is unaffected by the wait
+	auto pong = ipc.ping();
+	if (pong.wait_for(PONG_TIMEOUT) != std::future_status::ready)
 	{
-		LOG_WARNING("Discord", "Failed to send ping");
+		LOG_WARNING("Discord", "No PONG response within " + std::to_string(PONG_TIMEOUT.count()) + " seconds");
 		return false;
 	}
-
-	// Read and process PONG response
-	int opcode;
-	std::string response;
-	if (ipc.readFrame(opcode, response))
+	if (!pong.get().ok)
 	{
-		if (opcode != OP_PONG)
-		{
-			LOG_WARNING_STREAM("Discord", "Unexpected response to PING. Opcode: " << opcode);
-			return false;
-		}
-	}
-	else
-	{
-		LOG_WARNING("Discord", "Failed to read PONG response");
+		LOG_WARNING("Discord", "Failed to send ping or read PONG response");
 		return false;
 	}
 
@@ -623,17 +819,46 @@ void Discord::start()
 void Discord::stop()
 {
 	LOG_INFO("Discord", "Stopping Discord Rich Presence");
-	running = false;
+	{
+		std::lock_guard<std::mutex> lock(frame_queue_mutex);
+		LOG_INFO("Discord", "Presence frames sent: " + std::to_string(frames_sent) +
+								", suppressed as redundant: " + std::to_string(frames_suppressed));
+	}
+	{
+		std::lock_guard<std::mutex> lock(work_mutex);
+		running = false;
+		work_cv.notify_all();
+	}
 
 	if (conn_thread.joinable())
 	{
 		ThreadUtils::joinWithTimeout(conn_thread, std::chrono::seconds(3), "Discord connection thread");
 	}
 
-	if (ipc.isConnected())
+	// Make sure no timer fires into a stopped (or destroyed) object. A flush that is
+	// already running has cleared flush_timer, so wait for it separately; with running
+	// false it can't schedule another one
+	Scheduler::TaskId pending_flush;
 	{
-		ipc.closePipe();
+		std::unique_lock<std::mutex> lock(frame_queue_mutex);
+		flush_cv.wait(lock, [this]()
+					  { return !flush_running; });
+		pending_flush = flush_timer;
+		flush_timer = 0;
+	}
+	// Waits if this flush has just started running
+	if (pending_flush)
+	{
+		Scheduler::getInstance().cancel(pending_flush);
 	}
+	if (work_timer)
+	{
+		Scheduler::getInstance().cancel(work_timer);
+		work_timer = 0;
+	}
+
+	// Also joins the reader thread if the connection dropped on its own
+	ipc.closePipe();
 }
 
 void Discord::setConnectedCallback(ConnectionCallback callback)
@@ -15,10 +15,40 @@ inline void safe_localtime(std::tm *tm_ptr, const std::time_t *time_ptr)
 
 using json = nlohmann::json;
 
-DiscordIPC::DiscordIPC() : connected(false)
+namespace
+{
+    // How long a write may wait for Discord to drain a full socket buffer
+    constexpr int WRITE_TIMEOUT_MS = 5000;
+
+    // Initial receive buffer size; it only grows for frames larger than this
+    constexpr size_t RECEIVE_BUFFER_SIZE = 16 * 1024;
+
+    constexpr size_t FRAME_HEADER_SIZE = 8;
+
+#ifndef _WIN32
+    // Blocking syscalls would ignore WRITE_TIMEOUT_MS; readSome/writeParts poll instead
+    void makeNonBlocking(int fd)
+    {
+        int flags = fcntl(fd, F_GETFL, 0);
+        if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+        {
+            LOG_WARNING("DiscordIPC", "Failed to make socket non-blocking: " + std::string(strerror(errno)));
+        }
+    }
+#endif
+}
+
+DiscordIPC::DiscordIPC(size_t max_frame_size) : connected(false),
+                                                 established(false),
+                                                 next_ping_id(0),
+                                                 max_frame_size(max_frame_size),
+                                                 recv_buffer(RECEIVE_BUFFER_SIZE),
+                                                 recv_start(0),
+                                                 recv_end(0)
 {
 #ifdef _WIN32
     pipe_handle = INVALID_HANDLE_VALUE;
+    stop_event = CreateEvent(NULL, TRUE, FALSE, NULL);
 #else
     pipe_fd = -1;
 #endif
@@ -26,10 +56,13 @@ DiscordIPC::DiscordIPC() : connected(false)
 
 DiscordIPC::~DiscordIPC()
 {
-    if (connected)
+    closePipe();
+#ifdef _WIN32
+    if (stop_event)
     {
-        closePipe();
+        CloseHandle(stop_event);
     }
+#endif
 }
 
 #if defined(_WIN32)
@@ -37,6 +70,7 @@ bool DiscordIPC::openPipe()
 {
     // Windows implementation using named pipes
     LOG_INFO("DiscordIPC", "Attempting to connect to Discord via Windows named pipes");
+    ResetEvent(stop_event);
     for (int i = 0; i < 10; i++)
     {
         std::string pipeName = "\\\\.\\pipe\\discord-ipc-" + std::to_string(i);
@@ -48,7 +82,7 @@ bool DiscordIPC::openPipe()
             0,
             NULL,
             OPEN_EXISTING,
-            0,
+            FILE_FLAG_OVERLAPPED, // Lets the reader and writers use the pipe concurrently
             NULL);
 
         if (pipe_handle != INVALID_HANDLE_VALUE)
@@ -121,6 +155,11 @@ bool DiscordIPC::openPipe()
         {
             LOG_INFO("DiscordIPC", "Successfully connected to Discord socket: " + socket_path);
 
+            // No MSG_NOSIGNAL here; keep a closed socket from raising SIGPIPE on write
+            int on = 1;
+            setsockopt(pipe_fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+
+            makeNonBlocking(pipe_fd);
             connected = true;
             return true;
         }
@@ -189,6 +228,7 @@ bool DiscordIPC::openPipe()
         {
             LOG_INFO("DiscordIPC", "Successfully connected to Discord socket: " + socket_path);
 
+            makeNonBlocking(pipe_fd);
             connected = true;
             return true;
         }
@@ -214,6 +254,7 @@ bool DiscordIPC::openPipe()
         if (::connect(pipe_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
         {
             LOG_INFO("DiscordIPC", "Successfully connected to Discord Snap socket: " + snap_path);
+            makeNonBlocking(pipe_fd);
             connected = true;
             return true;
         }
@@ -238,6 +279,7 @@ bool DiscordIPC::openPipe()
         if (::connect(pipe_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
         {
             LOG_INFO("DiscordIPC", "Successfully connected to Discord Flatpak socket: " + flatpak_path);
+            makeNonBlocking(pipe_fd);
             connected = true;
             return true;
         }
@@ -254,207 +296,506 @@ bool DiscordIPC::openPipe()
 
 void DiscordIPC::closePipe()
 {
+    // Deliberate close: no closed callback
+    established = false;
     connected = false;
-    LOG_INFO("DiscordIPC", "Disconnecting from Discord...");
+
 #ifdef _WIN32
-    if (pipe_handle != INVALID_HANDLE_VALUE)
+    bool open = pipe_handle != INVALID_HANDLE_VALUE;
+#else
+    bool open = pipe_fd != -1;
+#endif
+    if (!open && !reader_thread.joinable())
     {
-        LOG_DEBUG("DiscordIPC", "Closing pipe handle");
-        CloseHandle(pipe_handle);
-        pipe_handle = INVALID_HANDLE_VALUE;
+        failPending();
+        return;
     }
+
+    LOG_INFO("DiscordIPC", "Disconnecting from Discord...");
+
+    // Wake the reader (and any writer blocked on a full pipe) before waiting for it
+#ifdef _WIN32
+    SetEvent(stop_event);
 #else
-    if (pipe_fd != -1)
+    if (open)
     {
-        LOG_DEBUG("DiscordIPC", "Closing socket");
-        close(pipe_fd);
-        pipe_fd = -1;
+        shutdown(pipe_fd, SHUT_RDWR);
+    }
+#endif
+    if (reader_thread.joinable())
+    {
+        if (reader_thread.get_id() == std::this_thread::get_id())
+        {
+            reader_thread.detach();
+        }
+        else
+        {
+            reader_thread.join();
+        }
     }
+
+    // The reader is gone, so nothing looks at buffered bytes of this connection anymore
+    recv_start = 0;
+    recv_end = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+#ifdef _WIN32
+        if (pipe_handle != INVALID_HANDLE_VALUE)
+        {
+            LOG_DEBUG("DiscordIPC", "Closing pipe handle");
+            CloseHandle(pipe_handle);
+            pipe_handle = INVALID_HANDLE_VALUE;
+        }
+#else
+        if (pipe_fd != -1)
+        {
+            LOG_DEBUG("DiscordIPC", "Closing socket");
+            close(pipe_fd);
+            pipe_fd = -1;
+        }
 #endif
+    }
+
+    failPending();
     LOG_INFO("DiscordIPC", "Disconnected from Discord");
 }
 
+void DiscordIPC::startReader()
+{
+    if (!connected || reader_thread.joinable())
+    {
+        return;
+    }
+
+    established = true;
+    reader_thread = std::thread(&DiscordIPC::readerLoop, this);
+}
+
+void DiscordIPC::setClosedCallback(std::function<void()> callback)
+{
+    closed_callback = callback;
+}
+
 bool DiscordIPC::isConnected() const
 {
     return connected;
 }
 
 bool DiscordIPC::writeFrame(int opcode, const std::string &payload)
+{
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (!connected)
+        {
+            LOG_DEBUG("DiscordIPC", "Can't write frame: not connected");
+            return false;
+        }
+
+        // Skip building the payload dump (a copy of every frame) unless it will be logged
+        if (Logger::getInstance().getLogLevel() <= LogLevel::Debug)
+        {
+            LOG_DEBUG("DiscordIPC", "Writing frame - Opcode: " + std::to_string(opcode) + ", Data length: " + std::to_string(payload.size()));
+            LOG_DEBUG("DiscordIPC", "Writing frame data: " + payload);
+        }
+
+        // Discord IPC header: opcode and payload length, little-endian
+        uint32_t header[2];
+        header[0] = htole32(static_cast<uint32_t>(opcode));
+        header[1] = htole32(static_cast<uint32_t>(payload.size()));
+
+        if (writeParts(reinterpret_cast<const char *>(header), sizeof(header), payload))
+        {
+            return true;
+        }
+        LOG_ERROR("DiscordIPC", "Failed to write frame of " + std::to_string(sizeof(header) + payload.size()) + " bytes");
+    }
+
+    // Outside write_mutex: this runs the closed callback and fails pending requests
+    markDisconnected();
+    return false;
+}
+
+bool DiscordIPC::readFrame(int &opcode, std::string_view &data)
 {
     if (!connected)
     {
-        LOG_DEBUG("DiscordIPC", "Can't write frame: not connected");
+        LOG_DEBUG("DiscordIPC", "Can't read frame: not connected");
         return false;
     }
 
-    LOG_DEBUG("DiscordIPC", "Writing frame - Opcode: " + std::to_string(opcode) + ", Data length: " + std::to_string(payload.size()));
-    LOG_DEBUG("DiscordIPC", "Writing frame data: " + payload);
+    opcode = -1;
 
-    // Create a properly formatted Discord IPC message
-    uint32_t len = static_cast<uint32_t>(payload.size());
-    std::vector<char> buf(8 + len); // Header (8 bytes) + payload
-    auto *p = reinterpret_cast<uint32_t *>(buf.data());
-    p[0] = htole32(opcode); // First 4 bytes: opcode with proper endianness
-    p[1] = htole32(len);    // Next 4 bytes: payload length with proper endianness
-    memcpy(buf.data() + 8, payload.data(), len);
+    // First the 8-byte header (opcode + length)
+    if (!fillReceiveBuffer(FRAME_HEADER_SIZE))
+    {
+        markDisconnected();
+        return false;
+    }
 
-#ifdef _WIN32
-    DWORD written;
-    if (!WriteFile(pipe_handle, buf.data(), 8 + len, &written, nullptr) ||
-        written != 8 + len)
+    // Parse the header with proper endianness handling
+    uint32_t raw0, raw1;
+    memcpy(&raw0, &recv_buffer[recv_start], 4);
+    memcpy(&raw1, &recv_buffer[recv_start + 4], 4);
+    opcode = le32toh(raw0);
+    uint32_t length = le32toh(raw1);
+
+    // The length comes straight from the peer: refuse to size a buffer after it blindly
+    if (length > max_frame_size)
     {
-        DWORD error = GetLastError();
-        LOG_ERROR("DiscordIPC", "Failed to write frame to pipe. Error code: " + std::to_string(error) + ", Bytes written: " + std::to_string(written));
-        connected = false;
+        LOG_ERROR("DiscordIPC", "Frame length " + std::to_string(length) + " exceeds the limit of " +
+                                    std::to_string(max_frame_size) + " bytes");
+        markDisconnected();
         return false;
     }
-    LOG_DEBUG("DiscordIPC", "Successfully wrote " + std::to_string(written) + " bytes to pipe");
-    FlushFileBuffers(pipe_handle);
-#else
-    ssize_t n = ::write(pipe_fd, buf.data(), 8 + len);
-    if (n != 8 + len)
+
+    // Then the payload, usually already buffered by the header read
+    if (!fillReceiveBuffer(FRAME_HEADER_SIZE + length))
+    {
+        markDisconnected();
+        return false;
+    }
+
+    data = std::string_view(recv_buffer.data() + recv_start + FRAME_HEADER_SIZE, length);
+    recv_start += FRAME_HEADER_SIZE + length;
+
+    if (Logger::getInstance().getLogLevel() <= LogLevel::Debug)
     {
-        LOG_ERROR("DiscordIPC", "Failed to write frame to socket. Expected: " + std::to_string(8 + len) + ", Actual: " + std::to_string(n));
-        if (n < 0)
+        LOG_DEBUG("DiscordIPC", "Read frame - Opcode: " + std::to_string(opcode) + ", Data: " + std::string(data));
+    }
+    return true;
+}
+
+bool DiscordIPC::fillReceiveBuffer(size_t needed)
+{
+    if (recv_start == recv_end)
+    {
+        // Everything consumed: start over at the front for free
+        recv_start = 0;
+        recv_end = 0;
+    }
+    if (recv_end - recv_start >= needed)
+    {
+        return true;
+    }
+
+    // Not enough room behind the unconsumed bytes: move them to the front, and grow
+    // (up to one maximal frame) only if the frame is larger than the buffer
+    if (recv_start + needed > recv_buffer.size())
+    {
+        memmove(recv_buffer.data(), recv_buffer.data() + recv_start, recv_end - recv_start);
+        recv_end -= recv_start;
+        recv_start = 0;
+        if (needed > recv_buffer.size())
         {
-            LOG_ERROR("DiscordIPC", "Write error: " + std::string(strerror(errno)));
+            recv_buffer.resize(needed);
         }
-        connected = false;
-        return false;
     }
-    LOG_DEBUG("DiscordIPC", "Successfully wrote " + std::to_string(n) + " bytes to socket");
-#endif
+
+    while (recv_end - recv_start < needed)
+    {
+        size_t received;
+        if (!readSome(recv_buffer.data() + recv_end, recv_buffer.size() - recv_end, received))
+        {
+            return false;
+        }
+        recv_end += received;
+    }
     return true;
 }
 
-bool DiscordIPC::readFrame(int &opcode, std::string &data)
+#ifdef _WIN32
+bool DiscordIPC::overlappedIo(bool write, char *buf, DWORD len, DWORD &transferred)
 {
-    if (!connected)
+    OVERLAPPED overlapped = {};
+    overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!overlapped.hEvent)
     {
-        LOG_DEBUG("DiscordIPC", "Can't read frame: not connected");
         return false;
     }
 
-    LOG_DEBUG("DiscordIPC", "Attempting to read frame from Discord");
-    opcode = -1;
+    transferred = 0;
+    BOOL ok = write ? WriteFile(pipe_handle, buf, len, NULL, &overlapped)
+                    : ReadFile(pipe_handle, buf, len, NULL, &overlapped);
+    DWORD error = ok ? ERROR_SUCCESS : GetLastError();
+    if (error == ERROR_IO_PENDING)
+    {
+        // Wait for the transfer, or for closePipe() to ask us to give up
+        HANDLE events[2] = {overlapped.hEvent, stop_event};
+        if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+        {
+            CancelIoEx(pipe_handle, &overlapped);
+        }
+        error = ERROR_SUCCESS;
+    }
 
-    // First read the 8-byte header (opcode + length)
-    char header[8];
-    int header_bytes_read = 0;
+    // A message-mode pipe reports a partial read of a longer message as ERROR_MORE_DATA
+    if (error == ERROR_SUCCESS || error == ERROR_MORE_DATA)
+    {
+        error = GetOverlappedResult(pipe_handle, &overlapped, &transferred, TRUE) ? ERROR_SUCCESS : GetLastError();
+    }
+    CloseHandle(overlapped.hEvent);
 
-#ifdef _WIN32
-    LOG_DEBUG("DiscordIPC", "Reading header (8 bytes)...");
-    while (header_bytes_read < 8)
+    if (error != ERROR_SUCCESS && error != ERROR_MORE_DATA)
     {
-        DWORD bytes_read;
-        if (!ReadFile(pipe_handle, header + header_bytes_read, 8 - header_bytes_read, &bytes_read, NULL))
+        if (connected)
         {
-            DWORD error = GetLastError();
-            LOG_ERROR("DiscordIPC", "Failed to read header: error code " + std::to_string(error));
-            connected = false;
-            return false;
+            LOG_ERROR("DiscordIPC", std::string(write ? "Failed to write to pipe" : "Failed to read from pipe") +
+                                        ": error code " + std::to_string(error));
         }
+        return false;
+    }
+    return true;
+}
 
-        if (bytes_read == 0)
+bool DiscordIPC::readSome(char *buf, size_t len, size_t &received)
+{
+    DWORD bytes_read;
+    if (!overlappedIo(false, buf, static_cast<DWORD>(len), bytes_read))
+    {
+        return false;
+    }
+    if (bytes_read == 0)
+    {
+        LOG_ERROR("DiscordIPC", "Read zero bytes from pipe - connection closed");
+        return false;
+    }
+    received = bytes_read;
+    return true;
+}
+
+bool DiscordIPC::writeParts(const char *header, size_t header_len, const std::string &payload)
+{
+    // Pipes have no gather write, and a message-mode pipe needs the frame in one write
+    write_buffer.assign(header, header + header_len);
+    write_buffer.insert(write_buffer.end(), payload.begin(), payload.end());
+
+    size_t total = 0;
+    while (total < write_buffer.size())
+    {
+        DWORD written;
+        if (!overlappedIo(true, write_buffer.data() + total, static_cast<DWORD>(write_buffer.size() - total), written))
         {
-            LOG_ERROR("DiscordIPC", "Read zero bytes from pipe - connection closed");
-            connected = false;
             return false;
         }
-
-        header_bytes_read += bytes_read;
-        LOG_DEBUG("DiscordIPC", "Read " + std::to_string(bytes_read) + " header bytes, total: " + std::to_string(header_bytes_read) + "/8");
+        total += written;
     }
+    return true;
+}
 #else
-    LOG_DEBUG("DiscordIPC", "Reading header (8 bytes)...");
-    while (header_bytes_read < 8)
+bool DiscordIPC::readSome(char *buf, size_t len, size_t &received)
+{
+    while (true)
     {
-        ssize_t bytes_read = read(pipe_fd, header + header_bytes_read, 8 - header_bytes_read);
+        ssize_t bytes_read = read(pipe_fd, buf, len);
+        if (bytes_read < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            // Nothing buffered: wait for data (closePipe()'s shutdown() also wakes us)
+            struct pollfd pfd;
+            pfd.fd = pipe_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (poll(&pfd, 1, -1) >= 0 || errno == EINTR)
+            {
+                continue;
+            }
+            LOG_ERROR("DiscordIPC", "Error waiting for socket data: " + std::string(strerror(errno)));
+            return false;
+        }
         if (bytes_read <= 0)
         {
+            // After closePipe() this is our own shutdown, not an error
+            if (!connected)
+            {
+                return false;
+            }
             if (bytes_read < 0)
             {
                 LOG_ERROR("DiscordIPC", "Error reading from socket: " + std::string(strerror(errno)));
             }
             else
             {
-                LOG_ERROR("DiscordIPC", "Socket closed during header read");
+                LOG_ERROR("DiscordIPC", "Socket closed by Discord");
             }
-            connected = false;
             return false;
         }
-        header_bytes_read += bytes_read;
-        LOG_DEBUG("DiscordIPC", "Read " + std::to_string(bytes_read) + " header bytes, total: " + std::to_string(header_bytes_read) + "/8");
-    }
-#endif
-
-    // Parse the header with proper endianness handling
-    uint32_t raw0, raw1;
-    memcpy(&raw0, header, 4);
-    memcpy(&raw1, header + 4, 4);
-    opcode = le32toh(raw0);
-    uint32_t length = le32toh(raw1);
-
-    LOG_DEBUG("DiscordIPC", "Frame header parsed - Opcode: " + std::to_string(opcode) + ", Expected data length: " + std::to_string(length));
-
-    if (length == 0)
-    {
-        LOG_DEBUG("DiscordIPC", "Frame has zero length, no data to read");
-        data.clear();
+        received = static_cast<size_t>(bytes_read);
         return true;
     }
+}
 
-    // Now read the actual payload data
-    data.resize(length);
-    uint32_t data_bytes_read = 0;
-
-#ifdef _WIN32
-    LOG_DEBUG("DiscordIPC", "Reading payload (" + std::to_string(length) + " bytes)...");
-    while (data_bytes_read < length)
+bool DiscordIPC::writeParts(const char *header, size_t header_len, const std::string &payload)
+{
+    // Header and payload go out straight from their buffers, in one syscall when possible
+    struct iovec parts[2];
+    parts[0].iov_base = const_cast<char *>(header);
+    parts[0].iov_len = header_len;
+    parts[1].iov_base = const_cast<char *>(payload.data());
+    parts[1].iov_len = payload.size();
+
+    struct iovec *iov = parts;
+    int count = payload.empty() ? 1 : 2;
+    while (count > 0)
     {
-        DWORD bytes_read;
-        if (!ReadFile(pipe_handle, &data[data_bytes_read], length - data_bytes_read, &bytes_read, NULL))
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = iov;
+        message.msg_iovlen = count;
+
+        // MSG_NOSIGNAL: a socket Discord closed reports EPIPE instead of killing us with SIGPIPE
+        ssize_t written = sendmsg(pipe_fd, &message, MSG_NOSIGNAL);
+        if (written < 0)
         {
-            DWORD error = GetLastError();
-            LOG_ERROR("DiscordIPC", "Failed to read data: error code " + std::to_string(error));
-            connected = false;
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                // Socket buffer full: wait for Discord to drain it
+                struct pollfd pfd;
+                pfd.fd = pipe_fd;
+                pfd.events = POLLOUT;
+                pfd.revents = 0;
+                int ready = poll(&pfd, 1, WRITE_TIMEOUT_MS);
+                if (ready > 0 || (ready < 0 && errno == EINTR))
+                {
+                    continue;
+                }
+                LOG_ERROR("DiscordIPC", "Timed out waiting for socket to become writable");
+                return false;
+            }
+            LOG_ERROR("DiscordIPC", "Write error: " + std::string(strerror(errno)));
             return false;
         }
 
-        if (bytes_read == 0)
+        // Partial write: drop the parts that went out and advance into the next one
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len)
         {
-            LOG_ERROR("DiscordIPC", "Read zero bytes from pipe during payload read - connection closed");
-            connected = false;
-            return false;
+            remaining -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = static_cast<char *>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
         }
+    }
+    return true;
+}
+#endif
+
+void DiscordIPC::readerLoop()
+{
+    LOG_DEBUG("DiscordIPC", "Reader thread started");
 
-        data_bytes_read += bytes_read;
-        LOG_DEBUG("DiscordIPC", "Read " + std::to_string(bytes_read) + " data bytes, total: " + std::to_string(data_bytes_read) + "/" + std::to_string(length));
+    int opcode;
+    std::string_view data;
+    while (connected && readFrame(opcode, data))
+    {
+        dispatchFrame(opcode, data);
     }
-#else
-    LOG_DEBUG("DiscordIPC", "Reading payload (" + std::to_string(length) + " bytes)...");
-    while (data_bytes_read < length)
+    markDisconnected();
+
+    LOG_DEBUG("DiscordIPC", "Reader thread stopped");
+}
+
+void DiscordIPC::dispatchFrame(int opcode, std::string_view data)
+{
+    ReplyHandler handler;
+
+    if (opcode == OP_PONG)
     {
-        ssize_t bytes_read = read(pipe_fd, &data[data_bytes_read], length - data_bytes_read);
-        if (bytes_read <= 0)
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        if (!pending_pings.empty())
         {
-            if (bytes_read < 0)
-            {
-                LOG_ERROR("DiscordIPC", "Error reading from socket: " + std::string(strerror(errno)));
-            }
-            else
+            handler = std::move(pending_pings.front().handler);
+            pending_pings.pop_front();
+        }
+    }
+    else if (opcode == OP_PING)
+    {
+        // Discord checking on us: answer with the same payload
+        writeFrame(OP_PONG, std::string(data));
+        return;
+    }
+    else if (opcode == OP_CLOSE)
+    {
+        LOG_WARNING("DiscordIPC", "Discord closed the connection: " + std::string(data));
+        markDisconnected();
+        return;
+    }
+    else if (opcode == OP_FRAME)
+    {
+        try
+        {
+            json frame = json::parse(data.begin(), data.end());
+            if (frame.contains("nonce") && frame["nonce"].is_string())
             {
-                LOG_ERROR("DiscordIPC", "Socket closed during payload read");
+                std::lock_guard<std::mutex> lock(pending_mutex);
+                auto it = pending_requests.find(frame["nonce"].get<std::string>());
+                if (it != pending_requests.end())
+                {
+                    handler = std::move(it->second);
+                    pending_requests.erase(it);
+                }
             }
-            connected = false;
-            return false;
         }
-        data_bytes_read += bytes_read;
-        LOG_DEBUG("DiscordIPC", "Read " + std::to_string(bytes_read) + " data bytes, total: " + std::to_string(data_bytes_read) + "/" + std::to_string(length));
+        catch (const std::exception &e)
+        {
+            LOG_WARNING("DiscordIPC", "Failed to parse frame: " + std::string(e.what()));
+        }
+    }
+
+    if (!handler)
+    {
+        LOG_DEBUG("DiscordIPC", "Ignoring unsolicited frame with opcode " + std::to_string(opcode));
+        return;
+    }
+
+    Reply reply;
+    reply.ok = true;
+    reply.opcode = opcode;
+    reply.data = std::string(data);
+    handler(reply);
+}
+
+void DiscordIPC::markDisconnected()
+{
+    bool was_connected = connected.exchange(false);
+    failPending();
+
+    if (was_connected && established && closed_callback)
+    {
+        closed_callback();
+    }
+}
+
+void DiscordIPC::failPending()
+{
+    std::unordered_map<std::string, ReplyHandler> requests;
+    std::deque<PendingPing> pings;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        requests.swap(pending_requests);
+        pings.swap(pending_pings);
+    }
+
+    Reply failed;
+    for (auto &entry : requests)
+    {
+        entry.second(failed);
+    }
+    for (auto &entry : pings)
+    {
+        entry.handler(failed);
     }
-#endif
-    LOG_DEBUG("DiscordIPC", "Reading frame data: " + data);
-    return true;
 }
 
 bool DiscordIPC::sendHandshake(uint64_t clientId)
@@ -478,17 +819,77 @@ bool DiscordIPC::sendHandshake(uint64_t clientId)
     return writeFrame(OP_HANDSHAKE, handshake_str);
 }
 
-bool DiscordIPC::sendPing()
+bool DiscordIPC::sendRequest(const std::string &nonce, const std::string &payload, ReplyHandler handler)
+{
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        pending_requests[nonce] = std::move(handler);
+    }
+
+    if (!writeFrame(OP_FRAME, payload))
+    {
+        // Fail only this request: if the connection broke, markDisconnected() has already
+        // failed it along with the others; if it was never connected, it is still pending
+        ReplyHandler own;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex);
+            auto it = pending_requests.find(nonce);
+            if (it != pending_requests.end())
+            {
+                own = std::move(it->second);
+                pending_requests.erase(it);
+            }
+        }
+        if (own)
+        {
+            own(Reply());
+        }
+        return false;
+    }
+    return true;
+}
+
+std::future<DiscordIPC::Reply> DiscordIPC::ping()
 {
+    auto promise = std::make_shared<std::promise<Reply>>();
+    std::future<Reply> future = promise->get_future();
+
     if (!connected)
     {
         LOG_DEBUG("DiscordIPC", "Can't send ping: not connected");
-        return false;
+        promise->set_value(Reply());
+        return future;
+    }
+
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        id = next_ping_id++;
+        pending_pings.push_back({id, [promise](const Reply &reply)
+                                 { promise->set_value(reply); }});
     }
 
     LOG_DEBUG("DiscordIPC", "Sending ping");
     static const json ping = json::object(); // empty payload
-    std::string ping_str = ping.dump();
-
-    return writeFrame(OP_PING, ping_str);
+    if (!writeFrame(OP_PING, ping.dump()))
+    {
+        // As in sendRequest: fail only this ping, the others are not ours to resolve
+        ReplyHandler own;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex);
+            auto it = std::find_if(pending_pings.begin(), pending_pings.end(),
+                                   [id](const PendingPing &entry)
+                                   { return entry.id == id; });
+            if (it != pending_pings.end())
+            {
+                own = std::move(it->handler);
+                pending_pings.erase(it);
+            }
+        }
+        if (own)
+        {
+            own(Reply());
+        }
+    }
+    return future;
 }
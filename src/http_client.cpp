@@ -1,28 +1,156 @@
 #include "http_client.h"
-#include "thread_utils.h"
 
-HttpClient::HttpClient()
+namespace
+{
+    // Idle handles kept per origin; enough for the few concurrent lookups we do per server
+    constexpr size_t MAX_IDLE_HANDLES_PER_ORIGIN = 4;
+}
+
+HttpConnectionPool &HttpConnectionPool::getInstance()
+{
+    static HttpConnectionPool instance;
+    return instance;
+}
+
+HttpConnectionPool::HttpConnectionPool()
 {
     curl_global_init(CURL_GLOBAL_ALL);
-    m_curl = curl_easy_init();
-    LOG_DEBUG("HttpClient", "HttpClient initialized");
+
+    m_share = curl_share_init();
+    if (m_share)
+    {
+        curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, lockCallback);
+        curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, unlockCallback);
+        curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        // Connections are deliberately not shared: libcurl does not support using a shared
+        // connection cache from concurrent threads. Reusing per-origin handles keeps them warm instead.
+    }
+    LOG_DEBUG("HttpClient", "HTTP connection pool initialized");
 }
 
-HttpClient::~HttpClient()
+HttpConnectionPool::~HttpConnectionPool()
 {
-    if (m_sseRunning)
+    for (auto &[origin, handles] : m_idleHandles)
     {
-        stopSSE();
+        for (CURL *handle : handles)
+        {
+            curl_easy_cleanup(handle);
+        }
     }
+    m_idleHandles.clear();
 
-    if (m_curl)
+    if (m_share)
     {
-        curl_easy_cleanup(m_curl);
-        m_curl = nullptr;
+        curl_share_cleanup(m_share);
+        m_share = nullptr;
     }
 
     curl_global_cleanup();
-    LOG_DEBUG("HttpClient", "HttpClient object destroyed");
+}
+
+void HttpConnectionPool::lockCallback(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+    static_cast<HttpConnectionPool *>(userptr)->m_shareLocks[data].lock();
+}
+
+void HttpConnectionPool::unlockCallback(CURL *handle, curl_lock_data data, void *userptr)
+{
+    static_cast<HttpConnectionPool *>(userptr)->m_shareLocks[data].unlock();
+}
+
+std::string HttpConnectionPool::originKey(const std::string &url)
+{
+    size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string::npos)
+    {
+        return url;
+    }
+
+    std::string scheme = url.substr(0, schemeEnd);
+    size_t hostStart = schemeEnd + 3;
+    size_t hostEnd = url.find_first_of("/?#", hostStart);
+    std::string authority = url.substr(hostStart, hostEnd == std::string::npos ? std::string::npos : hostEnd - hostStart);
+
+    // Drop any credentials and add the default port so equivalent URLs share a key
+    size_t at = authority.rfind('@');
+    if (at != std::string::npos)
+    {
+        authority = authority.substr(at + 1);
+    }
+    size_t bracket = authority.rfind(']');
+    size_t colon = authority.rfind(':');
+    if (colon == std::string::npos || (bracket != std::string::npos && colon < bracket))
+    {
+        authority += (scheme == "https") ? ":443" : ":80";
+    }
+
+    return scheme + "://" + authority;
+}
+
+CURL *HttpConnectionPool::acquire(const std::string &url)
+{
+    std::string key = originKey(url);
+    CURL *handle = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        auto it = m_idleHandles.find(key);
+        if (it != m_idleHandles.end() && !it->second.empty())
+        {
+            handle = it->second.back();
+            it->second.pop_back();
+        }
+    }
+
+    if (handle)
+    {
+        // Resetting keeps the handle's connection, DNS and session caches
+        curl_easy_reset(handle);
+        LOG_DEBUG("HttpClient", "Reusing pooled handle for " + key);
+    }
+    else
+    {
+        handle = curl_easy_init();
+        if (!handle)
+        {
+            return nullptr;
+        }
+        LOG_DEBUG("HttpClient", "Created new handle for " + key);
+    }
+
+    attachShare(handle);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    return handle;
+}
+
+void HttpConnectionPool::release(const std::string &url, CURL *handle)
+{
+    if (!handle)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        auto &handles = m_idleHandles[originKey(url)];
+        if (handles.size() < MAX_IDLE_HANDLES_PER_ORIGIN)
+        {
+            handles.push_back(handle);
+            return;
+        }
+    }
+
+    curl_easy_cleanup(handle);
+}
+
+void HttpConnectionPool::attachShare(CURL *handle)
+{
+    if (m_share)
+    {
+        curl_easy_setopt(handle, CURLOPT_SHARE, m_share);
+    }
 }
 
 size_t HttpClient::writeCallback(char *ptr, size_t size, size_t nmemb, void *userdata)
@@ -33,6 +161,11 @@ size_t HttpClient::writeCallback(char *ptr, size_t size, size_t nmemb, void *use
     return totalSize;
 }
 
+size_t HttpClient::discardCallback(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    return size * nmemb;
+}
+
 struct curl_slist *HttpClient::createHeaderList(const std::map<std::string, std::string> &headers)
 {
     struct curl_slist *curl_headers = NULL;
@@ -45,23 +178,22 @@ struct curl_slist *HttpClient::createHeaderList(const std::map<std::string, std:
     return curl_headers;
 }
 
-bool HttpClient::setupCommonOptions(const std::string &url, const std::map<std::string, std::string> &headers)
+bool HttpClient::setupCommonOptions(CURL *curl, const std::string &url, const std::map<std::string, std::string> &headers)
 {
-    if (!m_curl)
+    if (!curl)
     {
         LOG_ERROR("HttpClient", "CURL not initialized");
         return false;
     }
 
-    curl_easy_reset(m_curl);
-    curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(m_curl, CURLOPT_TIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
 
     LOG_DEBUG_STREAM("HttpClient", "Set up request to URL: " << url);
     return true;
 }
 
-bool HttpClient::checkResponse(CURLcode res)
+bool HttpClient::checkResponse(CURL *curl, CURLcode res)
 {
     if (res != CURLE_OK)
     {
@@ -70,7 +202,7 @@ bool HttpClient::checkResponse(CURLcode res)
     }
 
     long response_code;
-    curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, &response_code);
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
 
     if (response_code < 200 || response_code >= 300)
     {
@@ -86,22 +218,24 @@ bool HttpClient::get(const std::string &url, const std::map<std::string, std::st
 {
     LOG_INFO_STREAM("HttpClient", "Sending GET request to: " << url);
 
-    if (!setupCommonOptions(url, headers))
+    CURL *curl = HttpConnectionPool::getInstance().acquire(url);
+    if (!setupCommonOptions(curl, url, headers))
     {
         return false;
     }
 
-    curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
     struct curl_slist *curl_headers = createHeaderList(headers);
-    curl_easy_setopt(m_curl, CURLOPT_HTTPHEADER, curl_headers);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, curl_headers);
 
     LOG_DEBUG("HttpClient", "Executing GET request");
-    CURLcode res = curl_easy_perform(m_curl);
+    CURLcode res = curl_easy_perform(curl);
     curl_slist_free_all(curl_headers);
 
-    bool success = checkResponse(res);
+    bool success = checkResponse(curl, res);
+    HttpConnectionPool::getInstance().release(url, curl);
     if (success)
     {
         LOG_DEBUG_STREAM("HttpClient", "GET request succeeded with response size: " << response.size() << " bytes");
@@ -115,24 +249,26 @@ bool HttpClient::post(const std::string &url, const std::map<std::string, std::s
     LOG_INFO_STREAM("HttpClient", "Sending POST request to: " << url);
     LOG_DEBUG_STREAM("HttpClient", "POST body size: " << body.size() << " bytes");
 
-    if (!setupCommonOptions(url, headers))
+    CURL *curl = HttpConnectionPool::getInstance().acquire(url);
+    if (!setupCommonOptions(curl, url, headers))
     {
         return false;
     }
 
-    curl_easy_setopt(m_curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(m_curl, CURLOPT_POSTFIELDS, body.c_str());
-    curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
 
     struct curl_slist *curl_headers = createHeaderList(headers);
-    curl_easy_setopt(m_curl, CURLOPT_HTTPHEADER, curl_headers);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, curl_headers);
 
     LOG_DEBUG("HttpClient", "Executing POST request");
-    CURLcode res = curl_easy_perform(m_curl);
+    CURLcode res = curl_easy_perform(curl);
     curl_slist_free_all(curl_headers);
 
-    bool success = checkResponse(res);
+    bool success = checkResponse(curl, res);
+    HttpConnectionPool::getInstance().release(url, curl);
     if (success)
     {
         LOG_DEBUG_STREAM("HttpClient", "POST request succeeded with response size: " << response.size() << " bytes");
@@ -140,180 +276,137 @@ bool HttpClient::post(const std::string &url, const std::map<std::string, std::s
     return success;
 }
 
-size_t HttpClient::sseCallback(char *ptr, size_t size, size_t nmemb, void *userdata)
+int HttpClient::race(const std::vector<std::string> &urls, const std::map<std::string, std::string> &headers,
+                     std::chrono::milliseconds stagger, std::chrono::milliseconds timeout)
 {
-    HttpClient *client = static_cast<HttpClient *>(userdata);
-    size_t total_size = size * nmemb;
-
-    client->m_sseBuffer.append(ptr, total_size);
-    LOG_DEBUG_STREAM("HttpClient", "SSE received " << total_size << " bytes");
-
-    // Process events in buffer
-    size_t pos;
-    while ((pos = client->m_sseBuffer.find("\n\n")) != std::string::npos)
+    if (urls.empty())
     {
-        std::string event = client->m_sseBuffer.substr(0, pos);
-        client->m_sseBuffer.erase(0, pos + 2); // +2 for \n\n
-
-        size_t data_pos = event.find("data: ");
-        if (data_pos != std::string::npos)
-        {
-            std::string data = event.substr(data_pos + 6);
-            LOG_DEBUG_STREAM("HttpClient", "SSE event received, data size: " << data.size() << " bytes");
-            if (client->m_eventCallback)
-            {
-                LOG_DEBUG("HttpClient", "Calling SSE event callback");
-                client->m_eventCallback(data);
-            }
-        }
+        return -1;
     }
 
-    return total_size;
-}
-
-int HttpClient::sseCallbackProgress(void *clientp, curl_off_t dltotal, curl_off_t dlnow,
-                                    curl_off_t ultotal, curl_off_t ulnow)
-{
-    HttpClient *httpClient = static_cast<HttpClient *>(clientp);
-    if (httpClient->m_stopFlag)
+    CURLM *multi = curl_multi_init();
+    if (!multi)
     {
-        LOG_DEBUG("HttpClient", "SSE connection termination requested");
-        return 1; // Abort transfer
+        LOG_ERROR("HttpClient", "Failed to initialize CURL multi handle");
+        return -1;
     }
-    return 0; // Continue transfer
-}
 
-bool HttpClient::stopSSE()
-{
-    m_stopFlag = true;
-    LOG_INFO("HttpClient", "Requesting SSE connection termination");
+    struct curl_slist *curl_headers = createHeaderList(headers);
+    std::vector<CURL *> handles(urls.size(), nullptr);
+    std::vector<bool> started(urls.size(), false);
+    size_t finished = 0;
+    int winner = -1;
 
-    if (m_sseThread.joinable())
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + timeout;
+
+    while (winner < 0 && finished < urls.size())
     {
-        std::unique_lock<std::mutex> lock(m_sseMutex);
-        if (m_sseRunning)
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
         {
-            LOG_INFO("HttpClient", "Waiting for SSE thread to stop");
-            
-            bool threadStopped = m_sseCondVar.wait_for(lock, std::chrono::seconds(5), 
-                [this] { return !m_sseRunning; });
-                
-            if (!threadStopped) {
-                LOG_WARNING("HttpClient", "SSE thread did not respond to stop request in time");
-            }
+            break;
         }
-        
-        lock.unlock();
-        ThreadUtils::joinWithTimeout(m_sseThread, std::chrono::seconds(2), "SSE thread");
-    }
 
-    LOG_INFO("HttpClient", "SSE thread stopped successfully");
-    return true;
-}
+        // Start every candidate whose turn has come
+        auto nextStart = deadline;
+        for (size_t i = 0; i < urls.size(); i++)
+        {
+            if (started[i])
+            {
+                continue;
+            }
 
-bool HttpClient::startSSE(const std::string &url, const std::map<std::string, std::string> &headers,
-                          EventCallback callback)
-{
-    LOG_INFO_STREAM("HttpClient", "Starting SSE connection to: " << url);
+            auto due = start + stagger * static_cast<int>(i);
+            if (due > now)
+            {
+                nextStart = std::min(nextStart, due);
+                continue;
+            }
 
-    {
-        std::lock_guard<std::mutex> lock(m_sseMutex);
-        m_stopFlag = false;
-        m_sseRunning = true;
-        m_eventCallback = callback;
-        m_sseBuffer.clear();
-    }
+            started[i] = true;
 
-    m_sseThread = std::thread([this, url, headers]()
-                              {
-        LOG_INFO("HttpClient", "SSE thread starting");
-        
-        try {
-            CURL* sse_curl = curl_easy_init();
-            if (!sse_curl) {
-                LOG_ERROR("HttpClient", "Failed to initialize CURL for SSE connection");
-                std::lock_guard<std::mutex> lock(m_sseMutex);
-                m_sseRunning = false;
-                m_sseCondVar.notify_all();
-                return;
+            // Fresh handles rather than pooled ones: a probe's connection lives in the race's
+            // own multi handle and closes with it, so a warm pooled handle would be wasted
+            CURL *curl = curl_easy_init();
+            if (!curl)
+            {
+                finished++;
+                continue;
             }
-            LOG_DEBUG("HttpClient", "CURL initialized for SSE connection");
-
-            int retryCount = 0;
-            while (!m_stopFlag) {
-                // Setup SSE connection
-                curl_easy_reset(sse_curl);
-                curl_easy_setopt(sse_curl, CURLOPT_URL, url.c_str());
-                curl_easy_setopt(sse_curl, CURLOPT_WRITEFUNCTION, sseCallback);
-                curl_easy_setopt(sse_curl, CURLOPT_WRITEDATA, this);
-                curl_easy_setopt(sse_curl, CURLOPT_TCP_NODELAY, 1L);
-                
-                // Setup progress monitoring for cancelation
-                curl_easy_setopt(sse_curl, CURLOPT_XFERINFOFUNCTION, sseCallbackProgress);
-                curl_easy_setopt(sse_curl, CURLOPT_XFERINFODATA, this);
-                curl_easy_setopt(sse_curl, CURLOPT_NOPROGRESS, 0L);
-
-                // Setup headers
-                struct curl_slist *curl_headers = createHeaderList(headers);
-                curl_headers = curl_slist_append(curl_headers, "Accept: text/event-stream");
-                curl_easy_setopt(sse_curl, CURLOPT_HTTPHEADER, curl_headers);
-
-                if (m_stopFlag) {
-                    LOG_INFO("HttpClient", "SSE connection setup aborted due to stop request");
-                    curl_slist_free_all(curl_headers);
-                    break;
-                }
+            HttpConnectionPool::getInstance().attachShare(curl);
+
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+            curl_easy_setopt(curl, CURLOPT_URL, urls[i].c_str());
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, curl_headers);
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discardCallback);
+            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(remaining.count()));
+            curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(remaining.count()));
+            curl_easy_setopt(curl, CURLOPT_PRIVATE, reinterpret_cast<char *>(i));
+            curl_multi_add_handle(multi, curl);
+            handles[i] = curl;
+            LOG_DEBUG("HttpClient", "Probing " + urls[i]);
+        }
 
-                // Perform request
-                LOG_INFO_STREAM("HttpClient", "Establishing SSE connection, attempt #" << (retryCount + 1));
-                CURLcode res = curl_easy_perform(sse_curl);
-                        
-                if (res == CURLE_ABORTED_BY_CALLBACK) {
-                    LOG_INFO("HttpClient", "SSE connection aborted by callback");
-                } else if (res != CURLE_OK) {
-                    retryCount++;
-                    LOG_WARNING_STREAM("HttpClient", "SSE connection error: " << curl_easy_strerror(res) 
-                                     << ", retry count: " << retryCount);
-                    if (!m_stopFlag) {
-                        int retryDelay = (std::min)(5 * retryCount, 60); // Exponential backoff with max 60 seconds
-                        LOG_DEBUG_STREAM("HttpClient", "Retrying SSE connection in " << retryDelay << " seconds");
-                        std::this_thread::sleep_for(std::chrono::seconds(retryDelay));
-                    }
-                } else {
-                    // Connection ended normally, reset retry count
-                    LOG_INFO("HttpClient", "SSE connection ended normally");
-                    retryCount = 0;
-                }
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        CURLMsg *msg;
+        int msgsLeft;
+        while ((msg = curl_multi_info_read(multi, &msgsLeft)))
+        {
+            if (msg->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
 
-                curl_slist_free_all(curl_headers);
+            char *privateData = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &privateData);
+            size_t index = reinterpret_cast<size_t>(privateData);
+            finished++;
 
-                if (m_stopFlag) {
-                    LOG_INFO("HttpClient", "Exiting SSE connection loop due to stop request");
-                    break;
+            long responseCode = 0;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &responseCode);
+            if (msg->data.result == CURLE_OK && responseCode >= 200 && responseCode < 300)
+            {
+                if (winner < 0)
+                {
+                    winner = static_cast<int>(index);
                 }
             }
-            
-            if (sse_curl) {
-                curl_easy_cleanup(sse_curl);
-                LOG_DEBUG("HttpClient", "Cleaned up CURL handle for SSE");
+            else
+            {
+                LOG_DEBUG("HttpClient", "Probe of " + urls[index] + " failed: " +
+                                            (msg->data.result != CURLE_OK
+                                                 ? std::string(curl_easy_strerror(msg->data.result))
+                                                 : "HTTP " + std::to_string(responseCode)));
             }
         }
-        catch (const std::exception& e) {
-            LOG_ERROR("HttpClient", "Exception in SSE thread: " + std::string(e.what()));
-        }
-        catch (...) {
-            LOG_ERROR("HttpClient", "Unknown exception in SSE thread");
+
+        if (winner >= 0 || finished >= urls.size())
+        {
+            break;
         }
-        
-        // Mark as not running and notify waiting threads
+
+        // Sleep until there is socket activity or the next candidate is due
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::min(nextStart, deadline) - std::chrono::steady_clock::now());
+        curl_multi_poll(multi, nullptr, 0, static_cast<int>(std::max<long long>(wait.count(), 0)), nullptr);
+    }
+
+    for (size_t i = 0; i < handles.size(); i++)
+    {
+        if (!handles[i])
         {
-            std::lock_guard<std::mutex> lock(m_sseMutex);
-            m_sseRunning = false;
-            m_sseCondVar.notify_all();
+            continue;
         }
-        
-        LOG_INFO("HttpClient", "SSE thread exiting"); });
 
-    LOG_DEBUG("HttpClient", "SSE thread started successfully");
-    return true;
-}
\ No newline at end of file
+        // Probe connections live in the race's own connection cache and close with it
+        curl_multi_remove_handle(multi, handles[i]);
+        curl_easy_cleanup(handles[i]);
+    }
+
+    curl_multi_cleanup(multi);
+    curl_slist_free_all(curl_headers);
+    return winner;
+}
@@ -0,0 +1,273 @@
+#include "metadata_store.h"
+
+namespace
+{
+    constexpr const char STORE_MAGIC[4] = {'P', 'F', 'P', 'M'};
+    constexpr const uint32_t STORE_VERSION = 1;
+    constexpr const size_t HEADER_SIZE = sizeof(STORE_MAGIC) + sizeof(uint32_t);
+    constexpr const size_t RECORD_HEADER_SIZE = 1 + 8 + 4 + 4;
+
+    // Refuse absurd lengths from a corrupted file instead of allocating them
+    constexpr const uint32_t MAX_FIELD_SIZE = 64 * 1024;
+
+    // Compact once dead records outnumber live ones by this factor
+    constexpr const size_t COMPACTION_RATIO = 2;
+
+    void putU32(std::string &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void putI64(std::string &out, int64_t value)
+    {
+        uint64_t bits = static_cast<uint64_t>(value);
+        for (int i = 0; i < 8; i++)
+        {
+            out.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+        }
+    }
+
+    uint32_t getU32(const std::string &in, size_t offset)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(in[offset + i])) << (8 * i);
+        }
+        return value;
+    }
+
+    int64_t getI64(const std::string &in, size_t offset)
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            bits |= static_cast<uint64_t>(static_cast<unsigned char>(in[offset + i])) << (8 * i);
+        }
+        return static_cast<int64_t>(bits);
+    }
+
+    std::string encodeHeader()
+    {
+        std::string out(STORE_MAGIC, sizeof(STORE_MAGIC));
+        putU32(out, STORE_VERSION);
+        return out;
+    }
+
+    std::string encodeRecord(const MetadataStore::Record &record)
+    {
+        std::string out;
+        out.reserve(RECORD_HEADER_SIZE + record.key.size() + record.value.size());
+        out.push_back(static_cast<char>(record.table));
+        putI64(out, std::chrono::duration_cast<std::chrono::seconds>(
+                        record.expires.time_since_epoch())
+                        .count());
+        putU32(out, static_cast<uint32_t>(record.key.size()));
+        putU32(out, static_cast<uint32_t>(record.value.size()));
+        out += record.key;
+        out += record.value;
+        return out;
+    }
+}
+
+MetadataStore::MetadataStore(std::filesystem::path path) : m_path(std::move(path))
+{
+}
+
+MetadataStore::~MetadataStore()
+{
+    close();
+}
+
+bool MetadataStore::load(const RecordVisitor &visitor)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_loaded)
+    {
+        return true;
+    }
+
+    std::string data;
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        if (in)
+        {
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+    }
+
+    // Latest record per (table, key); later records overwrite earlier ones
+    std::map<std::pair<Table, std::string>, Record> live;
+    size_t recordCount = 0;
+    bool needsRewrite = data.empty();
+
+    if (!data.empty())
+    {
+        if (data.size() < HEADER_SIZE ||
+            data.compare(0, sizeof(STORE_MAGIC), STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+            getU32(data, sizeof(STORE_MAGIC)) != STORE_VERSION)
+        {
+            LOG_WARNING("MetadataStore", "Ignoring unrecognised cache file: " + m_path.string());
+            needsRewrite = true;
+        }
+        else
+        {
+            auto now = std::chrono::system_clock::now();
+            size_t offset = HEADER_SIZE;
+            while (offset + RECORD_HEADER_SIZE <= data.size())
+            {
+                uint8_t table = static_cast<uint8_t>(data[offset]);
+                int64_t expires = getI64(data, offset + 1);
+                uint32_t keySize = getU32(data, offset + 9);
+                uint32_t valueSize = getU32(data, offset + 13);
+                if (keySize > MAX_FIELD_SIZE || valueSize > MAX_FIELD_SIZE ||
+                    offset + RECORD_HEADER_SIZE + keySize + valueSize > data.size())
+                {
+                    break;
+                }
+
+                Record record;
+                record.table = static_cast<Table>(table);
+                record.key = data.substr(offset + RECORD_HEADER_SIZE, keySize);
+                record.value = data.substr(offset + RECORD_HEADER_SIZE + keySize, valueSize);
+                record.expires = std::chrono::system_clock::time_point(std::chrono::seconds(expires));
+                offset += RECORD_HEADER_SIZE + keySize + valueSize;
+                recordCount++;
+
+                auto liveKey = std::make_pair(record.table, record.key);
+                if (record.expires > now)
+                {
+                    live[liveKey] = std::move(record);
+                }
+                else
+                {
+                    live.erase(liveKey);
+                }
+            }
+
+            if (offset != data.size())
+            {
+                LOG_WARNING("MetadataStore", "Cache file has a truncated tail, dropping it");
+                needsRewrite = true;
+            }
+        }
+    }
+
+    std::vector<Record> records;
+    records.reserve(live.size());
+    for (auto &[key, record] : live)
+    {
+        visitor(record);
+        records.push_back(std::move(record));
+    }
+
+    if (recordCount > COMPACTION_RATIO * records.size() + 16)
+    {
+        needsRewrite = true;
+    }
+
+    if (needsRewrite && !rewrite(records))
+    {
+        return false;
+    }
+
+    if (!openForAppend())
+    {
+        return false;
+    }
+
+    m_loaded = true;
+    LOG_INFO("MetadataStore", "Loaded " + std::to_string(records.size()) + " cached entries from " +
+                                  m_path.string());
+    return true;
+}
+
+bool MetadataStore::append(Table table, const std::string &key, const std::string &value,
+                           std::chrono::system_clock::time_point expires)
+{
+    if (key.size() > MAX_FIELD_SIZE || value.size() > MAX_FIELD_SIZE)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_out.is_open())
+    {
+        return false;
+    }
+
+    std::string encoded = encodeRecord(Record{table, key, value, expires});
+    m_out.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+    m_out.flush();
+    if (!m_out)
+    {
+        LOG_WARNING("MetadataStore", "Failed to write cache record, disabling persistence");
+        m_out.close();
+        return false;
+    }
+    return true;
+}
+
+void MetadataStore::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_out.is_open())
+    {
+        m_out.close();
+    }
+    m_loaded = false;
+}
+
+bool MetadataStore::rewrite(const std::vector<Record> &records)
+{
+    std::filesystem::path tempPath = m_path;
+    tempPath += ".tmp";
+
+    try
+    {
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                LOG_ERROR("MetadataStore", "Failed to open cache file for writing: " + tempPath.string());
+                return false;
+            }
+
+            std::string header = encodeHeader();
+            out.write(header.data(), static_cast<std::streamsize>(header.size()));
+            for (const auto &record : records)
+            {
+                std::string encoded = encodeRecord(record);
+                out.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+            }
+            if (!out)
+            {
+                LOG_ERROR("MetadataStore", "Failed to write cache file: " + tempPath.string());
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, m_path);
+        LOG_DEBUG("MetadataStore", "Compacted cache file to " + std::to_string(records.size()) + " entries");
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR("MetadataStore", "Error rewriting cache file: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool MetadataStore::openForAppend()
+{
+    m_out.open(m_path, std::ios::binary | std::ios::app);
+    if (!m_out)
+    {
+        LOG_ERROR("MetadataStore", "Failed to open cache file for appending: " + m_path.string());
+        return false;
+    }
+    return true;
+}
@@ -3,66 +3,179 @@
 // API endpoints and constants
 namespace
 {
-    constexpr const char *PLEX_TV_API_URL = "https://plex.tv/api/v2";
-    constexpr const char *PLEX_PIN_URL = "https://plex.tv/api/v2/pins";
+    constexpr const char *PLEX_TV_BASE_URL = "https://plex.tv";
+    constexpr const char *PLEX_PIN_PATH = "/api/v2/pins";
     constexpr const char *PLEX_AUTH_URL = "https://app.plex.tv/auth#";
-    constexpr const char *PLEX_USER_URL = "https://plex.tv/api/v2/user";
-    constexpr const char *PLEX_RESOURCES_URL = "https://plex.tv/api/v2/resources?includeHttps=1";
-    constexpr const char *JIKAN_API_URL = "https://api.jikan.moe/v4/anime";
+    constexpr const char *PLEX_USER_PATH = "/api/v2/user";
+    constexpr const char *PLEX_RESOURCES_PATH = "/api/v2/resources?includeHttps=1";
+    constexpr const char *JIKAN_API_BASE_URL = "https://api.jikan.moe";
+    constexpr const char *JIKAN_ANIME_PATH = "/v4/anime";
+    constexpr const char *JIKAN_API_HOST = "api.jikan.moe";
+    constexpr const char *TMDB_API_BASE_URL = "https://api.themoviedb.org";
+    constexpr const char *TMDB_API_HOST = "api.themoviedb.org";
     constexpr const char *TMDB_IMAGE_BASE_URL = "https://image.tmdb.org/t/p/w500";
     constexpr const char *SSE_NOTIFICATIONS_ENDPOINT = "/:/eventsource/notifications?filters=playing";
     constexpr const char *SESSION_ENDPOINT = "/status/sessions";
+    constexpr const char *IDENTITY_ENDPOINT = "/identity";
+    constexpr const char *METADATA_CACHE_FILE = "metadata_cache.bin";
+
+    // Environment variables that replace the base URLs above, e.g. to point the client
+    // at tools/mock_plex for benchmarking
+    constexpr const char *PLEX_TV_URL_ENV = "PRESENCE_PLEX_TV_URL";
+    constexpr const char *JIKAN_API_URL_ENV = "PRESENCE_JIKAN_API_URL";
+    constexpr const char *TMDB_API_URL_ENV = "PRESENCE_TMDB_API_URL";
+    constexpr const char *TMDB_IMAGE_URL_ENV = "PRESENCE_TMDB_IMAGE_URL";
+
+    std::string baseUrl(const char *envVar, const char *defaultUrl)
+    {
+        std::string url = defaultUrl;
+#ifdef _WIN32
+        char *value = nullptr;
+        size_t valueSize = 0;
+        _dupenv_s(&value, &valueSize, envVar);
+        if (value)
+        {
+            if (*value)
+            {
+                url = value;
+            }
+            free(value);
+        }
+#else
+        const char *value = getenv(envVar);
+        if (value && *value)
+        {
+            url = value;
+        }
+#endif
+        while (!url.empty() && url.back() == '/')
+        {
+            url.pop_back();
+        }
+        return url;
+    }
+
+    std::string plexTvUrl(const char *path)
+    {
+        static const std::string base = baseUrl(PLEX_TV_URL_ENV, PLEX_TV_BASE_URL);
+        return base + path;
+    }
+
+    std::string jikanApiUrl(const char *path)
+    {
+        static const std::string base = baseUrl(JIKAN_API_URL_ENV, JIKAN_API_BASE_URL);
+        return base + path;
+    }
+
+    std::string tmdbApiUrl(const std::string &path)
+    {
+        static const std::string base = baseUrl(TMDB_API_URL_ENV, TMDB_API_BASE_URL);
+        return base + path;
+    }
+
+    std::string tmdbImageUrl(const std::string &path)
+    {
+        static const std::string base = baseUrl(TMDB_IMAGE_URL_ENV, TMDB_IMAGE_BASE_URL);
+        return base + path;
+    }
 
     // Cache timeouts (in seconds)
     constexpr const int TMDB_CACHE_TIMEOUT = 86400;  // 24 hours
     constexpr const int MAL_CACHE_TIMEOUT = 86400;   // 24 hours
     constexpr const int MEDIA_CACHE_TIMEOUT = 3600;  // 1 hour
     constexpr const int SESSION_CACHE_TIMEOUT = 300; // 5 minutes
-}
+    constexpr const int LOOKUP_MISS_TIMEOUT = 600;   // 10 minutes, for "no artwork"/"no match" answers
 
-// Cache structures
-struct TimedCacheEntry
-{
-    time_t timestamp;
-    bool valid() const { return (std::time(nullptr) - timestamp) < MEDIA_CACHE_TIMEOUT; }
-};
+    // Cache budgets (entries, approximate bytes)
+    constexpr const size_t TMDB_CACHE_MAX_ENTRIES = 1024;
+    constexpr const size_t TMDB_CACHE_MAX_BYTES = 256 * 1024;
+    constexpr const size_t MAL_CACHE_MAX_ENTRIES = 1024;
+    constexpr const size_t MAL_CACHE_MAX_BYTES = 256 * 1024;
+    constexpr const size_t MEDIA_CACHE_MAX_ENTRIES = 256;
+    constexpr const size_t MEDIA_CACHE_MAX_BYTES = 2 * 1024 * 1024;
+    constexpr const size_t SESSION_CACHE_MAX_ENTRIES = 256;
+    constexpr const size_t SESSION_CACHE_MAX_BYTES = 64 * 1024;
+    constexpr const size_t SERVER_URI_CACHE_MAX_ENTRIES = 64;
+    constexpr const size_t SERVER_URI_CACHE_MAX_BYTES = 32 * 1024;
 
-struct TMDBCacheEntry : TimedCacheEntry
-{
-    std::string artPath;
-    bool valid() const { return (std::time(nullptr) - timestamp) < TMDB_CACHE_TIMEOUT; }
-};
+    // Bookkeeping cost per cache entry (list node, index bucket, timestamps)
+    constexpr const size_t CACHE_ENTRY_OVERHEAD = 64;
 
-struct MALCacheEntry : TimedCacheEntry
-{
-    std::string malId;
-    bool valid() const { return (std::time(nullptr) - timestamp) < MAL_CACHE_TIMEOUT; }
-};
+    size_t stringEntrySize(const std::string &key, const std::string &value)
+    {
+        return key.size() + value.size() + CACHE_ENTRY_OVERHEAD;
+    }
 
-struct MediaCacheEntry : TimedCacheEntry
-{
-    MediaInfo info;
-};
+    size_t mediaInfoEntrySize(const std::string &key, const MediaInfo &info)
+    {
+        size_t size = key.size() + sizeof(MediaInfo) + CACHE_ENTRY_OVERHEAD;
+        for (const std::string *field : {&info.title, &info.originalTitle, &info.artPath, &info.summary,
+                                         &info.imdbId, &info.tmdbId, &info.tvdbId, &info.malId, &info.animeQuery,
+                                         &info.grandparentTitle, &info.grandparentArt, &info.grandparentKey,
+                                         &info.album, &info.artist, &info.username,
+                                         &info.sessionKey, &info.serverId})
+        {
+            size += field->size();
+        }
+        for (const auto &genre : info.genres)
+        {
+            size += sizeof(std::string) + genre.size();
+        }
+        return size;
+    }
 
-struct SessionUserCacheEntry : TimedCacheEntry
-{
-    std::string username;
-    bool valid() const { return (std::time(nullptr) - timestamp) < SESSION_CACHE_TIMEOUT; }
-};
+    template <typename Key, typename Value>
+    void logCacheStats(const std::string &name, const LruCache<Key, Value> &cache)
+    {
+        auto stats = cache.stats();
+        LOG_DEBUG("Plex", name + " cache: " + std::to_string(stats.hits) + " hits, " +
+                              std::to_string(stats.misses) + " misses, " +
+                              std::to_string(stats.evictions) + " evictions, " +
+                              std::to_string(stats.expirations) + " expirations, " +
+                              std::to_string(stats.entries) + " entries (" +
+                              std::to_string(stats.bytes) + " bytes)");
+    }
 
-struct ServerUriCacheEntry : TimedCacheEntry
-{
-    std::string uri;
-    bool valid() const { return (std::time(nullptr) - timestamp) < SESSION_CACHE_TIMEOUT; } // Reuse session timeout
-};
+    // Minimum spacing between two /status/sessions snapshots of the same server, and how
+    // many snapshots a single unknown session may trigger
+    constexpr const auto SESSION_SNAPSHOT_DEBOUNCE = std::chrono::seconds(1);
+    constexpr const int SESSION_SNAPSHOT_ATTEMPTS = 2;
+
+    // Connection probing: head start given to each preferred URI, and overall deadline
+    constexpr const int URI_PROBE_STAGGER_MS = 250;
+    constexpr const int URI_PROBE_TIMEOUT_MS = 3000;
+
+    // Enrichment workers, concurrent requests allowed per host, and queued task limit
+    constexpr const size_t WORK_POOL_THREADS = 4;
+    constexpr const size_t WORK_POOL_PER_HOST_LIMIT = 2;
+    constexpr const size_t WORK_POOL_BACKLOG = 256;
 
-Plex::Plex() : m_initialized(false), m_shuttingDown(false)
+    // Start time jitter (in seconds) tolerated before a playing session counts as changed
+    constexpr const long long PLAYBACK_DRIFT_TOLERANCE = 2;
+}
+
+Plex::Plex() : m_initialized(false), m_shuttingDown(false),
+               m_tmdbArtworkCache(std::chrono::seconds(TMDB_CACHE_TIMEOUT), TMDB_CACHE_MAX_ENTRIES,
+                                  TMDB_CACHE_MAX_BYTES, stringEntrySize),
+               m_malIdCache(std::chrono::seconds(MAL_CACHE_TIMEOUT), MAL_CACHE_MAX_ENTRIES,
+                            MAL_CACHE_MAX_BYTES, stringEntrySize),
+               m_mediaInfoCache(std::chrono::seconds(MEDIA_CACHE_TIMEOUT), MEDIA_CACHE_MAX_ENTRIES,
+                                MEDIA_CACHE_MAX_BYTES, mediaInfoEntrySize),
+               m_sessionUserCache(std::chrono::seconds(SESSION_CACHE_TIMEOUT), SESSION_CACHE_MAX_ENTRIES,
+                                  SESSION_CACHE_MAX_BYTES, stringEntrySize),
+               m_serverUriCache(std::chrono::seconds(SESSION_CACHE_TIMEOUT), SERVER_URI_CACHE_MAX_ENTRIES,
+                                SERVER_URI_CACHE_MAX_BYTES, stringEntrySize),
+               m_metadataStore(Config::getConfigDirectory() / METADATA_CACHE_FILE),
+               m_workPool(WORK_POOL_THREADS, WORK_POOL_PER_HOST_LIMIT, WORK_POOL_BACKLOG)
 {
     LOG_INFO("Plex", "Plex object created");
 }
 
 Plex::~Plex()
 {
+    // Tasks on both threads use the members below, so stop them before any is destroyed
+    m_sseReactor.stop();
+    m_workPool.stop();
     LOG_INFO("Plex", "Plex object destroyed");
 }
 
@@ -77,6 +190,10 @@ bool Plex::init()
     m_initialized = false;
     m_shuttingDown = false;
 
+    // Warm the metadata caches from disk on the first start only
+    std::call_once(m_metadataStoreLoaded, [this]()
+                   { loadPersistentCache(); });
+
     // Check if we have a Plex auth token
     auto &config = Config::getInstance();
     std::string authToken = config.getPlexAuthToken();
@@ -110,6 +227,7 @@ bool Plex::init()
     setupServerConnections();
 
     m_initialized = true;
+    publishPlaybackIfChanged();
     return true;
 }
 
@@ -162,6 +280,28 @@ std::map<std::string, std::string> Plex::getStandardHeaders(const std::string &t
     return headers;
 }
 
+bool Plex::waitUnlessShuttingDown(std::chrono::milliseconds delay)
+{
+    // The deadline lives on the shared timer service; this thread just blocks until
+    // either the timer or stop() signals it
+    bool due = false;
+    Scheduler::TaskId timer = Scheduler::getInstance().schedule(delay, [this, &due]()
+                                                                {
+        std::lock_guard<std::mutex> lock(m_shutdownMutex);
+        due = true;
+        m_shutdownCv.notify_all(); });
+
+    {
+        std::unique_lock<std::mutex> lock(m_shutdownMutex);
+        m_shutdownCv.wait(lock, [this, &due]()
+                          { return due || m_shuttingDown; });
+    }
+
+    // Also waits out a timer that is firing right now, since it refers to `due`
+    Scheduler::getInstance().cancel(timer);
+    return !m_shuttingDown;
+}
+
 bool Plex::acquireAuthToken()
 {
     LOG_INFO("Plex", "Acquiring Plex auth token");
@@ -195,7 +335,7 @@ bool Plex::requestPlexPin(std::string &pinId, std::string &pin, HttpClient &clie
     std::string response;
     std::string data = "strong=true";
 
-    if (!client.post(PLEX_PIN_URL, headers, data, response))
+    if (!client.post(plexTvUrl(PLEX_PIN_PATH), headers, data, response))
     {
         LOG_ERROR("Plex", "Failed to request PIN from Plex");
         return false;
@@ -253,33 +393,20 @@ bool Plex::pollForPinAuthorization(const std::string &pinId, const std::string &
 {
     const int maxAttempts = 30;  // Try for about 5 minutes
     const int pollInterval = 10; // seconds
-    const int sleepChunks = 10;  // Break sleep into smaller chunks
 
     LOG_INFO("Plex", "Waiting for user to authorize PIN...");
 
     for (int attempt = 0; attempt < maxAttempts; ++attempt)
     {
-        // Check if application is shutting down
-        if (m_shuttingDown)
-        {
-            LOG_INFO("Plex", "Application is shutting down, aborting PIN authorization");
-            return false;
-        }
-
-        // Wait before polling, but check for shutdown more frequently
-        for (int i = 0; i < sleepChunks && !m_shuttingDown; ++i)
-        {
-            std::this_thread::sleep_for(std::chrono::seconds(pollInterval / sleepChunks));
-        }
-
-        if (m_shuttingDown)
+        // Wait before polling; stop() cuts the wait short
+        if (!waitUnlessShuttingDown(std::chrono::seconds(pollInterval)))
         {
             LOG_INFO("Plex", "Application is shutting down, aborting PIN authorization");
             return false;
         }
 
         // Check PIN status
-        std::string statusUrl = std::string(PLEX_PIN_URL) + "/" + pinId;
+        std::string statusUrl = plexTvUrl(PLEX_PIN_PATH) + "/" + pinId;
         std::string statusResponse;
 
         if (!client.get(statusUrl, headers, statusResponse))
@@ -344,7 +471,7 @@ bool Plex::fetchAndSaveUsername(const std::string &authToken, const std::string
     // Make the request to fetch account information
     std::string response;
 
-    if (!client.get(PLEX_USER_URL, headers, response))
+    if (!client.get(plexTvUrl(PLEX_USER_PATH), headers, response))
     {
         LOG_ERROR("Plex", "Failed to fetch user information");
         return false;
@@ -420,7 +547,7 @@ bool Plex::fetchServers()
     // Make the request to Plex.tv
     std::string response;
 
-    if (!client.get(PLEX_RESOURCES_URL, headers, response))
+    if (!client.get(plexTvUrl(PLEX_RESOURCES_PATH), headers, response))
     {
         LOG_ERROR("Plex", "Failed to fetch servers from Plex.tv");
         return false;
@@ -466,26 +593,40 @@ bool Plex::parseServerJson(const std::string &jsonStr)
                                  " (" + server->clientIdentifier + ")" +
                                  (server->owned ? " [owned]" : " [shared]"));
 
-            // Process connections (we want both local and remote)
+            // Process connections (keep every candidate, local ones first, for probing later)
+            std::vector<std::string> publicUris;
             if (resource.contains("connections") && resource["connections"].is_array())
             {
                 for (const auto &connection : resource["connections"])
                 {
                     std::string uri = connection.value("uri", "");
                     bool isLocal = connection.value("local", false);
+                    if (uri.empty())
+                    {
+                        continue;
+                    }
 
                     if (isLocal)
                     {
-                        server->localUri = uri;
+                        if (server->localUri.empty())
+                        {
+                            server->localUri = uri;
+                        }
+                        server->uris.push_back(uri);
                         LOG_INFO("Plex", "  Local URI: " + uri);
                     }
                     else
                     {
-                        server->publicUri = uri;
+                        if (server->publicUri.empty())
+                        {
+                            server->publicUri = uri;
+                        }
+                        publicUris.push_back(uri);
                         LOG_INFO("Plex", "  Public URI: " + uri);
                     }
                 }
             }
+            server->uris.insert(server->uris.end(), publicUris.begin(), publicUris.end());
 
             // Add server to our map and config
             if (!server->localUri.empty() || !server->publicUri.empty())
@@ -493,7 +634,7 @@ bool Plex::parseServerJson(const std::string &jsonStr)
                 // Save to config with ownership status
                 config.addPlexServer(server->name, server->clientIdentifier,
                                      server->localUri, server->publicUri,
-                                     server->accessToken, server->owned);
+                                     server->accessToken, server->owned, server->uris);
             }
         }
 
@@ -513,7 +654,28 @@ void Plex::setupServerConnections()
 {
     LOG_INFO("Plex", "Setting up server connections");
 
-    for (auto &[id, server] : Config::getInstance().getPlexServers())
+    m_sseReactor.setIdleTimeout(std::chrono::seconds((std::max)(Config::getInstance().getSSEIdleTimeout(), 0)));
+    if (!m_workPool.start() || !m_sseReactor.start())
+    {
+        LOG_ERROR("Plex", "Failed to start SSE event loop");
+        return;
+    }
+
+    // Probe every server's connections at once so startup waits for the slowest
+    // server rather than the sum of all of them
+    auto servers = Config::getInstance().getPlexServers();
+    std::vector<std::future<std::string>> probes;
+    for (auto &[id, server] : servers)
+    {
+        probes.push_back(std::async(std::launch::async, [this, server]()
+                                    { return getPreferredServerUri(server); }));
+    }
+    for (auto &probe : probes)
+    {
+        probe.wait();
+    }
+
+    for (auto &[id, server] : servers)
     {
         setupServerSSEConnection(server);
     }
@@ -523,62 +685,55 @@ std::string Plex::getPreferredServerUri(const std::shared_ptr<PlexServer> &serve
 {
     // Check if we have a cached URI that's still valid
     std::string serverId = server->clientIdentifier;
+    if (auto cached = m_serverUriCache.get(serverId))
     {
-        std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-        auto cacheIt = m_serverUriCache.find(serverId);
-        if (cacheIt != m_serverUriCache.end() && cacheIt->second.valid())
+        LOG_DEBUG("Plex", "Using cached URI for server " + server->name + ": " + *cached);
+        return *cached;
+    }
+
+    // No valid cache entry: race every candidate connection, preferring earlier (local) ones
+    std::vector<std::string> candidates = server->uris;
+    if (candidates.empty())
+    {
+        for (const auto &uri : {server->localUri, server->publicUri})
         {
-            LOG_DEBUG("Plex", "Using cached URI for server " + server->name + ": " + cacheIt->second.uri);
-            return cacheIt->second.uri;
+            if (!uri.empty())
+            {
+                candidates.push_back(uri);
+            }
         }
     }
 
-    // No valid cache entry, determine the best URI to use
-    std::string serverUri;
-
-    // Only test local URI if it exists
-    if (!server->localUri.empty())
+    std::vector<std::string> probeUrls;
+    for (const auto &uri : candidates)
     {
-        LOG_DEBUG("Plex", "Testing local URI accessibility: " + server->localUri);
-        HttpClient testClient;
-        std::map<std::string, std::string> headers = getStandardHeaders(server->accessToken);
-        std::string response;
+        probeUrls.push_back(uri + IDENTITY_ENDPOINT);
+    }
 
-        // Try a basic request to check connectivity
-        if (testClient.get(server->localUri, headers, response))
-        {
-            LOG_INFO("Plex", "Local URI is accessible, using it: " + server->localUri);
-            serverUri = server->localUri;
-        }
-        else
-        {
-            LOG_INFO("Plex", "Local URI not accessible, falling back to public URI");
-            serverUri = server->publicUri;
-        }
+    std::string serverUri;
+    HttpClient probeClient;
+    int winner = probeClient.race(probeUrls, getStandardHeaders(server->accessToken),
+                                  std::chrono::milliseconds(URI_PROBE_STAGGER_MS),
+                                  std::chrono::milliseconds(URI_PROBE_TIMEOUT_MS));
+    if (winner >= 0)
+    {
+        serverUri = candidates[winner];
+        LOG_INFO("Plex", "Using " + serverUri + " for server " + server->name);
     }
     else
     {
-        serverUri = server->publicUri;
+        serverUri = !server->publicUri.empty() ? server->publicUri : server->localUri;
+        LOG_WARNING("Plex", "No connection to server " + server->name + " answered, falling back to " + serverUri);
     }
 
     // Cache the result
-    {
-        std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-        ServerUriCacheEntry entry;
-        entry.timestamp = std::time(nullptr);
-        entry.uri = serverUri;
-        m_serverUriCache[serverId] = entry;
-    }
+    m_serverUriCache.put(serverId, serverUri);
 
     return serverUri;
 }
 
 void Plex::setupServerSSEConnection(const std::shared_ptr<PlexServer> &server)
 {
-    // Create a new HTTP client for this server
-    server->httpClient = std::make_unique<HttpClient>();
-    server->running = true;
-
     // Get the preferred URI
     std::string serverUri = getPreferredServerUri(server);
 
@@ -598,25 +753,38 @@ void Plex::setupServerSSEConnection(const std::shared_ptr<PlexServer> &server)
     std::string sseUrl = serverUri + SSE_NOTIFICATIONS_ENDPOINT;
 
     // Set up callback for SSE events
-    auto callback = [this, id = server->clientIdentifier](const std::string &event)
+    auto callback = [this, id = server->clientIdentifier](const SSEEvent &event)
+    {
+        this->handleSSEEvent(id, event.data);
+    };
+
+    // After a drop, resync with the server since notifications may have been missed.
+    // The resync does HTTP, so it runs on the work pool rather than the event loop.
+    auto reconnectCallback = [this, id = server->clientIdentifier]()
     {
-        this->handleSSEEvent(id, event);
+        if (!m_workPool.post(id, [this, id]()
+                             { reconcileSessions(id); }))
+        {
+            LOG_WARNING("Plex", "Could not queue session reconciliation for server " + id);
+        }
     };
 
-    // Start SSE connection
-    if (!server->httpClient->startSSE(sseUrl, headers, callback))
+    // Register the stream with the shared event loop
+    if (!m_sseReactor.addStream(server->clientIdentifier, sseUrl, headers, callback, reconnectCallback))
     {
         LOG_ERROR("Plex", "Failed to set up SSE connection for server: " + server->name);
+        return;
     }
+    server->running = true;
 }
 
-void Plex::handleSSEEvent(const std::string &serverId, const std::string &event)
+void Plex::handleSSEEvent(const std::string &serverId, std::string_view event)
 {
     try
     {
-        auto json = nlohmann::json::parse(event);
+        auto json = nlohmann::json::parse(event.begin(), event.end());
 
-        LOG_DEBUG("Plex", "Received event from server " + serverId + ": " + event);
+        LOG_DEBUG("Plex", "Received event from server " + serverId + ": " + std::string(event));
 
         // Check for PlaySessionStateNotification
         if (json.contains("PlaySessionStateNotification"))
@@ -627,7 +795,7 @@ void Plex::handleSSEEvent(const std::string &serverId, const std::string &event)
     catch (const std::exception &e)
     {
         LOG_ERROR("Plex", "Error parsing SSE event: " + std::string(e.what()) +
-                              ", Event: " + event.substr(0, 100) + (event.length() > 100 ? "..." : ""));
+                              ", Event: " + std::string(event.substr(0, 100)) + (event.length() > 100 ? "..." : ""));
     }
 }
 
@@ -652,26 +820,48 @@ void Plex::processPlaySessionStateNotification(const std::string &serverId, cons
 
     LOG_DEBUG("Plex", "Playback state update received: " + state + " sessionKey: " + sessionKey);
 
-    std::lock_guard<std::mutex> lock(m_sessionMutex);
-
     if (state == "playing" || state == "paused" || state == "buffering")
     {
-        updateSessionInfo(serverId, sessionKey, state, mediaKey, viewOffset, server);
+        auto receivedAt = std::chrono::steady_clock::now();
+
+        // Stamp the notification so an older, slower enrichment can't overwrite a newer one
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+            generation = ++m_sessionGeneration;
+            m_sessionGenerations[sessionKey] = generation;
+        }
+
+        // Enrichment does network I/O, so hand it to the work pool (one concurrency group
+        // per server); the generation stamp keeps out-of-order completions harmless
+        bool queued = m_workPool.post(serverId, [this, serverId, sessionKey, state, mediaKey, viewOffset, server, generation, receivedAt]()
+                                      { updateSessionInfo(serverId, sessionKey, state, mediaKey, viewOffset, server, generation, receivedAt); });
+        if (!queued)
+        {
+            LOG_WARNING("Plex", "Could not queue update for session: " + sessionKey);
+        }
     }
     else if (state == "stopped")
     {
-        // Remove the session if it exists
-        if (m_activeSessions.find(sessionKey) != m_activeSessions.end())
         {
-            LOG_INFO("Plex", "Removing stopped session: " + sessionKey);
-            m_activeSessions.erase(sessionKey);
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+            m_sessionGenerations.erase(sessionKey);
+
+            // Remove the session if it exists
+            if (m_activeSessions.find(sessionKey) != m_activeSessions.end())
+            {
+                LOG_INFO("Plex", "Removing stopped session: " + sessionKey);
+                m_activeSessions.erase(sessionKey);
+            }
         }
+        publishPlaybackIfChanged();
     }
 }
 
 void Plex::updateSessionInfo(const std::string &serverId, const std::string &sessionKey,
                              const std::string &state, const std::string &mediaKey,
-                             int64_t viewOffset, const std::shared_ptr<PlexServer> &server)
+                             int64_t viewOffset, const std::shared_ptr<PlexServer> &server,
+                             uint64_t generation, std::chrono::steady_clock::time_point receivedAt)
 {
     // Get the preferred URI
     std::string serverUri = getPreferredServerUri(server);
@@ -679,54 +869,11 @@ void Plex::updateSessionInfo(const std::string &serverId, const std::string &ses
     // For owned servers, we need to check if this session belongs to the current user
     if (server->owned)
     {
-        // Create cache key for session user info
-        std::string sessionUserCacheKey = serverUri + sessionKey;
-        bool needUserFetch = true;
-        std::string username;
-
-        {
-            std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-            auto cacheIt = m_sessionUserCache.find(sessionUserCacheKey);
-            if (cacheIt != m_sessionUserCache.end() && cacheIt->second.valid())
-            {
-                username = cacheIt->second.username;
-                needUserFetch = false;
-                LOG_DEBUG("Plex", "Using cached user info for session: " + sessionKey);
-            }
-        }
-
-        if (needUserFetch)
+        std::string username = resolveSessionUsername(serverUri, server->accessToken, sessionKey);
+        if (username.empty())
         {
-            username = fetchSessionUsername(serverUri, server->accessToken, sessionKey);
-
-            if (!username.empty())
-            {
-                std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-                SessionUserCacheEntry entry;
-                entry.timestamp = std::time(nullptr);
-                entry.username = username;
-                m_sessionUserCache[sessionUserCacheKey] = entry;
-            }
-            else
-            {
-                LOG_DEBUG("Plex", "No username found for session: " + sessionKey +
-                                      ", retrying after a short delay");
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                username = fetchSessionUsername(serverUri, server->accessToken, sessionKey);
-                if (!username.empty())
-                {
-                    std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-                    SessionUserCacheEntry entry;
-                    entry.timestamp = std::time(nullptr);
-                    entry.username = username;
-                    m_sessionUserCache[sessionUserCacheKey] = entry;
-                }
-                else
-                {
-                    LOG_WARNING("Plex", "Did not find a username tied to session, not updating: " + sessionKey);
-                    return;
-                }
-            }
+            LOG_WARNING("Plex", "Did not find a username tied to session, not updating: " + sessionKey);
+            return;
         }
 
         // Skip sessions that don't belong to the current user
@@ -740,33 +887,20 @@ void Plex::updateSessionInfo(const std::string &serverId, const std::string &ses
     // Create a cache key for media info
     std::string mediaInfoCacheKey = serverUri + mediaKey;
 
-    // Check if we have cached media info that's still valid
-    MediaInfo info;
-    bool needMediaFetch = true;
-
-    {
-        std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-        auto cacheIt = m_mediaInfoCache.find(mediaInfoCacheKey);
-        if (cacheIt != m_mediaInfoCache.end() && cacheIt->second.valid())
+    // Concurrent misses for the same media (playing/buffering bursts) share one fetch
+    MediaInfo info = m_mediaFlight.run(mediaInfoCacheKey, [&]()
+                                       {
+        if (auto cached = m_mediaInfoCache.get(mediaInfoCacheKey))
         {
-            info = cacheIt->second.info;
-            needMediaFetch = false;
             LOG_DEBUG("Plex", "Using cached media info for key: " + mediaKey);
+            return *cached;
         }
-    }
 
-    // Fetch media details if needed
-    if (needMediaFetch)
-    {
-        info = fetchMediaDetails(serverUri, server->accessToken, mediaKey);
+        MediaInfo fetched = fetchMediaDetails(serverUri, server->accessToken, mediaKey);
 
         // Cache the result
-        std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-        MediaCacheEntry entry;
-        entry.timestamp = std::time(nullptr);
-        entry.info = info;
-        m_mediaInfoCache[mediaInfoCacheKey] = entry;
-    }
+        m_mediaInfoCache.put(mediaInfoCacheKey, fetched);
+        return fetched; });
 
     // Update playback state
     updatePlaybackState(info, state, viewOffset);
@@ -775,11 +909,33 @@ void Plex::updateSessionInfo(const std::string &serverId, const std::string &ses
     info.sessionKey = sessionKey;
     info.serverId = serverId;
 
-    // Store the updated info
-    m_activeSessions[sessionKey] = info;
+    // Commit the staged record unless a newer notification for this session superseded it.
+    // Artwork and MAL IDs are applied under the lock so a lookup finishing concurrently
+    // is either seen here or patched in by applyEnrichmentToSessions().
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        auto genIt = m_sessionGenerations.find(sessionKey);
+        if (genIt == m_sessionGenerations.end() || genIt->second != generation)
+        {
+            LOG_DEBUG("Plex", "Discarding superseded update for session: " + sessionKey);
+            return;
+        }
+        applyCachedEnrichment(info);
+
+        // Time-to-presence is measured from the first notification for this media
+        auto existing = m_activeSessions.find(sessionKey);
+        bool sameMedia = existing != m_activeSessions.end() && isSameMedia(existing->second, info);
+        info.detectedAt = sameMedia ? existing->second.detectedAt : receivedAt;
+
+        m_activeSessions[sessionKey] = info;
+    }
+    publishPlaybackIfChanged();
 
     LOG_INFO("Plex", "Updated session " + sessionKey + ": " + info.title +
                          " (" + std::to_string(info.progress) + "/" + std::to_string(info.duration) + "s)");
+
+    // The basic presence is out (with pending placeholders); look up the rest in parallel
+    requestEnrichment(info);
 }
 
 void Plex::updatePlaybackState(MediaInfo &info, const std::string &state, int64_t viewOffset)
@@ -801,60 +957,160 @@ void Plex::updatePlaybackState(MediaInfo &info, const std::string &state, int64_
     info.startTime = std::time(nullptr) - static_cast<time_t>(info.progress);
 }
 
-std::string Plex::fetchSessionUsername(const std::string &serverUri, const std::string &accessToken,
-                                       const std::string &sessionKey)
+std::string Plex::resolveSessionUsername(const std::string &serverUri, const std::string &accessToken,
+                                         const std::string &sessionKey)
+{
+    std::string cacheKey = serverUri + sessionKey;
+    if (auto cached = m_sessionUserCache.get(cacheKey))
+    {
+        LOG_DEBUG("Plex", "Using cached user info for session: " + sessionKey);
+        return *cached;
+    }
+
+    // Unknown session: refresh the server's snapshot. A brand new session may not be
+    // listed yet, so allow one more (debounced) refresh before giving up.
+    for (int attempt = 0; attempt < SESSION_SNAPSHOT_ATTEMPTS && !m_shuttingDown; attempt++)
+    {
+        refreshSessionSnapshot(serverUri, accessToken);
+        if (auto cached = m_sessionUserCache.get(cacheKey))
+        {
+            LOG_INFO("Plex", "Found user for session " + sessionKey + ": " + *cached);
+            return *cached;
+        }
+        LOG_DEBUG("Plex", "Session " + sessionKey + " not found in sessions snapshot");
+    }
+
+    return "";
+}
+
+bool Plex::refreshSessionSnapshot(const std::string &serverUri, const std::string &accessToken)
 {
-    LOG_DEBUG("Plex", "Fetching username for session: " + sessionKey);
+    // Sessions appearing together on one server share a single snapshot
+    return m_sessionSnapshotFlight.run(serverUri, [&]()
+                                       {
+        // Debounce: don't hit the same server more than once per window
+        std::chrono::steady_clock::duration wait{0};
+        {
+            std::lock_guard<std::mutex> lock(m_sessionSnapshotMutex);
+            auto it = m_sessionSnapshotTimes.find(serverUri);
+            if (it != m_sessionSnapshotTimes.end())
+            {
+                wait = it->second + SESSION_SNAPSHOT_DEBOUNCE - std::chrono::steady_clock::now();
+            }
+        }
+        if (wait > std::chrono::steady_clock::duration::zero() &&
+            !waitUnlessShuttingDown(std::chrono::ceil<std::chrono::milliseconds>(wait)))
+        {
+            return false;
+        }
+
+        std::vector<SessionListExtractor::Session> sessions;
+        bool fetched = fetchSessionList(serverUri, accessToken, sessions);
+
+        {
+            std::lock_guard<std::mutex> lock(m_sessionSnapshotMutex);
+            m_sessionSnapshotTimes[serverUri] = std::chrono::steady_clock::now();
+        }
+        return fetched; });
+}
+
+bool Plex::fetchSessionList(const std::string &serverUri, const std::string &accessToken,
+                            std::vector<SessionListExtractor::Session> &sessions)
+{
+    LOG_DEBUG("Plex", "Fetching sessions snapshot from " + serverUri);
 
     HttpClient client;
     std::map<std::string, std::string> headers = getStandardHeaders(accessToken);
-
-    std::string url = serverUri + SESSION_ENDPOINT;
     std::string response;
 
-    if (!client.get(url, headers, response))
+    if (!client.get(serverUri + SESSION_ENDPOINT, headers, response))
     {
         LOG_ERROR("Plex", "Failed to fetch session information");
-        return "";
+        return false;
     }
 
     try
     {
-        auto json = nlohmann::json::parse(response);
+        SessionListExtractor::collect(response, sessions);
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR("Plex", "Error parsing session data: " + std::string(e.what()));
+        return false;
+    }
 
-        if (!json.contains("MediaContainer"))
-        {
-            LOG_ERROR("Plex", "Invalid session response format" + response);
-            return "";
-        }
-        if (json["MediaContainer"].contains("size") && json["MediaContainer"]["size"].get<int>() == 0)
+    // Index every session's user at once so later notifications hit the cache
+    for (const auto &session : sessions)
+    {
+        if (!session.username.empty())
         {
-            LOG_DEBUG("Plex", "No active sessions found");
-            return "";
+            m_sessionUserCache.put(serverUri + session.sessionKey, session.username);
         }
+    }
+    LOG_DEBUG("Plex", "Indexed " + std::to_string(sessions.size()) + " sessions from " + serverUri);
+    return true;
+}
 
-        // Find the matching session by sessionKey
-        for (const auto &session : json["MediaContainer"]["Metadata"])
+void Plex::reconcileSessions(const std::string &serverId)
+{
+    auto &servers = Config::getInstance().getPlexServers();
+    auto serverIt = servers.find(serverId);
+    if (serverIt == servers.end() || m_shuttingDown)
+    {
+        return;
+    }
+    auto server = serverIt->second;
+
+    // Notifications sent while the stream was down are lost; rebuild from the server's view
+    LOG_INFO("Plex", "Reconciling sessions for server " + server->name + " after reconnect");
+    std::string serverUri = getPreferredServerUri(server);
+    std::vector<SessionListExtractor::Session> sessions;
+    if (!fetchSessionList(serverUri, server->accessToken, sessions))
+    {
+        LOG_WARNING("Plex", "Could not reconcile sessions for server " + server->name);
+        return;
+    }
+
+    std::set<std::string> liveSessions;
+    for (const auto &session : sessions)
+    {
+        liveSessions.insert(session.sessionKey);
+    }
+
+    // Drop sessions of this server that ended during the gap
+    bool removed = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        for (auto it = m_activeSessions.begin(); it != m_activeSessions.end();)
         {
-            if (session.contains("sessionKey") && session["sessionKey"].get<std::string>() == sessionKey)
+            if (it->second.serverId == serverId && liveSessions.count(it->first) == 0)
             {
-                // Extract user info
-                if (session.contains("User") && session["User"].contains("title"))
-                {
-                    std::string username = session["User"]["title"].get<std::string>();
-                    LOG_INFO("Plex", "Found user for session " + sessionKey + ": " + username);
-                    return username;
-                }
-                break;
+                LOG_INFO("Plex", "Removing session that ended while disconnected: " + it->first);
+                m_sessionGenerations.erase(it->first);
+                it = m_activeSessions.erase(it);
+                removed = true;
+            }
+            else
+            {
+                ++it;
             }
         }
     }
-    catch (const std::exception &e)
+    if (removed)
     {
-        LOG_ERROR("Plex", "Error parsing session data: " + std::string(e.what()));
+        publishPlaybackIfChanged();
     }
 
-    return "";
+    // Replay the current state of every live session as if its notification had arrived
+    for (const auto &session : sessions)
+    {
+        nlohmann::json notification = {
+            {"sessionKey", session.sessionKey},
+            {"state", session.state},
+            {"key", session.mediaKey},
+            {"viewOffset", session.viewOffset}};
+        processPlaySessionStateNotification(serverId, notification);
+    }
 }
 
 MediaInfo Plex::fetchMediaDetails(const std::string &serverUri, const std::string &accessToken,
@@ -879,17 +1135,14 @@ MediaInfo Plex::fetchMediaDetails(const std::string &serverUri, const std::strin
 
     try
     {
-        auto json = nlohmann::json::parse(response);
-
-        if (!json.contains("MediaContainer") || !json["MediaContainer"].contains("Metadata") ||
-            json["MediaContainer"]["Metadata"].empty())
+        // Only the first item's scalar fields, GUIDs and genres are materialised
+        nlohmann::json metadata;
+        if (!MetadataExtractor::extractFirst(response, metadata))
         {
             LOG_ERROR("Plex", "Invalid media details response");
             return info;
         }
 
-        auto metadata = json["MediaContainer"]["Metadata"][0];
-
         // Extract common info first
         extractBasicMediaInfo(metadata, info);
 
@@ -975,37 +1228,46 @@ void Plex::fetchGrandparentMetadata(const std::string &serverUrl, const std::str
         return;
     }
 
-    LOG_DEBUG("Plex", "Fetching TV show metadata for key: " + info.grandparentKey);
+    // Make the request; episodes of the same show arriving together share one fetch
+    std::string url = serverUrl + info.grandparentKey;
+    nlohmann::json metadata = m_grandparentFlight.run(url, [&]()
+                                                      {
+        LOG_DEBUG("Plex", "Fetching TV show metadata for key: " + info.grandparentKey);
 
-    // Create HTTP client
-    HttpClient client;
+        HttpClient client;
+        std::map<std::string, std::string> headers = getStandardHeaders(accessToken);
+        std::string response;
 
-    // Set up headers
-    std::map<std::string, std::string> headers = getStandardHeaders(accessToken);
+        if (!client.get(url, headers, response))
+        {
+            LOG_ERROR("Plex", "Failed to fetch TV show metadata");
+            return nlohmann::json();
+        }
 
-    // Make the request
-    std::string url = serverUrl + info.grandparentKey;
-    std::string response;
+        try
+        {
+            nlohmann::json metadata;
+            if (!MetadataExtractor::extractFirst(response, metadata))
+            {
+                LOG_ERROR("Plex", "Invalid TV show metadata response");
+                return nlohmann::json();
+            }
 
-    if (!client.get(url, headers, response))
+            return metadata;
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("Plex", "Error parsing TV show metadata: " + std::string(e.what()));
+            return nlohmann::json();
+        } });
+
+    if (metadata.is_null())
     {
-        LOG_ERROR("Plex", "Failed to fetch TV show metadata");
         return;
     }
 
     try
     {
-        auto json = nlohmann::json::parse(response);
-
-        if (!json.contains("MediaContainer") || !json["MediaContainer"].contains("Metadata") ||
-            json["MediaContainer"]["Metadata"].empty())
-        {
-            LOG_ERROR("Plex", "Invalid TV show metadata response");
-            return;
-        }
-
-        auto metadata = json["MediaContainer"]["Metadata"][0];
-
         parseGuid(metadata, info);
 
         // Parse genres
@@ -1032,35 +1294,6 @@ void Plex::parseGuid(const nlohmann::json &metadata, MediaInfo &info)
             else if (id.find("tmdb://") == 0)
             {
                 info.tmdbId = id.substr(7);
-
-                // Check TMDB artwork cache
-                bool needArtworkFetch = true;
-                {
-                    std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-                    auto cacheIt = m_tmdbArtworkCache.find(info.tmdbId);
-                    if (cacheIt != m_tmdbArtworkCache.end() && cacheIt->second.valid())
-                    {
-                        info.artPath = cacheIt->second.artPath;
-                        needArtworkFetch = false;
-                        LOG_DEBUG("Plex", "Using cached TMDB artwork for ID: " + info.tmdbId);
-                    }
-                }
-
-                if (needArtworkFetch)
-                {
-                    fetchTMDBArtwork(info.tmdbId, info);
-
-                    // Cache the result if we found artwork
-                    if (!info.artPath.empty())
-                    {
-                        std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-                        TMDBCacheEntry entry;
-                        entry.timestamp = std::time(nullptr);
-                        entry.artPath = info.artPath;
-                        m_tmdbArtworkCache[info.tmdbId] = entry;
-                    }
-                }
-
                 LOG_INFO("Plex", "Found TMDB ID: " + info.tmdbId);
             }
         }
@@ -1079,7 +1312,9 @@ void Plex::parseGenres(const nlohmann::json &metadata, MediaInfo &info)
 
     if (isAnimeContent(metadata))
     {
-        fetchAnimeMetadata(metadata, info);
+        // Searched on MyAnimeList by requestEnrichment()
+        info.animeQuery = metadata.value("title", "Unknown") + "_" +
+                          std::to_string(metadata.value("year", 0));
     }
 }
 
@@ -1099,83 +1334,252 @@ bool Plex::isAnimeContent(const nlohmann::json &metadata)
     return false;
 }
 
-void Plex::fetchAnimeMetadata(const nlohmann::json &metadata, MediaInfo &info)
+bool Plex::applyCachedEnrichment(MediaInfo &info)
 {
-    LOG_INFO("Plex", "Anime detected, searching MyAnimeList via Jikan API");
+    bool changed = false;
 
-    // Create cache key (use title as key)
-    std::string cacheKey = metadata.value("title", "Unknown") + "_" +
-                           std::to_string(metadata.value("year", 0));
+    // A cached entry, even an empty one, means the lookup has finished
+    if (!info.tmdbId.empty() && info.artPath.empty())
+    {
+        auto artPath = m_tmdbArtworkCache.get(info.tmdbId);
+        if (artPath && !artPath->empty())
+        {
+            info.artPath = *artPath;
+            changed = true;
+        }
+        if (info.artworkPending != !artPath)
+        {
+            info.artworkPending = !artPath;
+            changed = true;
+        }
+    }
+
+    if (!info.animeQuery.empty() && info.malId.empty())
+    {
+        auto malId = m_malIdCache.get(info.animeQuery);
+        if (malId && !malId->empty())
+        {
+            info.malId = *malId;
+            changed = true;
+        }
+        if (info.malIdPending != !malId)
+        {
+            info.malIdPending = !malId;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+void Plex::requestEnrichment(const MediaInfo &info)
+{
+    if (info.artworkPending)
+    {
+        postEnrichment(TMDB_API_HOST, "tmdb:" + info.tmdbId, [this, tmdbId = info.tmdbId, type = info.type]()
+                       { lookupTMDBArtwork(tmdbId, type); });
+    }
+
+    if (info.malIdPending)
+    {
+        LOG_INFO("Plex", "Anime detected, searching MyAnimeList via Jikan API");
+        postEnrichment(JIKAN_API_HOST, "mal:" + info.animeQuery, [this, query = info.animeQuery]()
+                       { lookupMALId(query); });
+    }
+}
 
-    // Check if we have cached MAL info
-    bool needMALFetch = true;
+void Plex::postEnrichment(const std::string &host, const std::string &key, std::function<void()> lookup)
+{
     {
-        std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-        auto cacheIt = m_malIdCache.find(cacheKey);
-        if (cacheIt != m_malIdCache.end() && cacheIt->second.valid())
+        std::lock_guard<std::mutex> lock(m_enrichmentMutex);
+        if (!m_enrichmentInFlight.insert(key).second)
         {
-            info.malId = cacheIt->second.malId;
-            needMALFetch = false;
-            LOG_DEBUG("Plex", "Using cached MAL ID for: " + cacheKey);
+            return;
         }
     }
 
-    if (needMALFetch)
+    bool queued = m_workPool.post(host, [this, key, lookup = std::move(lookup)]()
+                                  {
+        lookup();
+        {
+            std::lock_guard<std::mutex> lock(m_enrichmentMutex);
+            m_enrichmentInFlight.erase(key);
+        }
+        applyEnrichmentToSessions(); });
+
+    if (!queued)
     {
-        HttpClient jikanClient;
-        std::string encodedTitle = cacheKey;
-        std::string::size_type pos = 0;
+        std::lock_guard<std::mutex> lock(m_enrichmentMutex);
+        m_enrichmentInFlight.erase(key);
+        LOG_WARNING("Plex", "Could not queue enrichment lookup: " + key);
+    }
+}
 
-        encodedTitle = urlEncode(encodedTitle);
+void Plex::applyEnrichmentToSessions()
+{
+    bool changed = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+        for (auto &[key, session] : m_activeSessions)
+        {
+            changed = applyCachedEnrichment(session) || changed;
+        }
+    }
 
-        std::string jikanUrl = std::string(JIKAN_API_URL) + "?q=" + encodedTitle;
+    if (changed)
+    {
+        publishPlaybackIfChanged();
+    }
+}
 
-        std::string jikanResponse;
-        if (jikanClient.get(jikanUrl, {}, jikanResponse))
+void Plex::lookupTMDBArtwork(const std::string &tmdbId, MediaType type)
+{
+    // Concurrent misses share one request
+    m_tmdbFlight.run(tmdbId, [&]()
+                     {
+        if (auto cached = m_tmdbArtworkCache.get(tmdbId))
         {
-            try
-            {
-                auto jikanJson = nlohmann::json::parse(jikanResponse);
-                if (jikanJson.contains("data") && !jikanJson["data"].empty())
-                {
-                    auto firstResult = jikanJson["data"][0];
-                    if (firstResult.contains("mal_id"))
+            LOG_DEBUG("Plex", "Using cached TMDB artwork for ID: " + tmdbId);
+            return *cached;
+        }
+
+        // Failed requests aren't cached, so a later notification retries them
+        std::string fetched;
+        if (!fetchTMDBArtwork(tmdbId, type, fetched))
+        {
+            return fetched;
+        }
+
+        // TMDB has no images for this ID: remember that briefly (in memory only) so it
+        // isn't asked again on every notification
+        if (fetched.empty())
+        {
+            m_tmdbArtworkCache.putUntil(tmdbId, fetched,
+                                        std::chrono::system_clock::now() + std::chrono::seconds(LOOKUP_MISS_TIMEOUT));
+            return fetched;
+        }
+
+        m_tmdbArtworkCache.put(tmdbId, fetched);
+        persistCacheEntry(MetadataStore::Table::TmdbArtwork, tmdbId, fetched, m_tmdbArtworkCache.ttl());
+        return fetched; });
+}
+
+void Plex::lookupMALId(const std::string &query)
+{
+    // Concurrent misses share one Jikan request
+    m_malFlight.run(query, [&]()
                     {
-                        info.malId = std::to_string(firstResult["mal_id"].get<int>());
-                        LOG_INFO("Plex", "Found MyAnimeList ID: " + info.malId);
-
-                        // Cache the result
-                        std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-                        MALCacheEntry entry;
-                        entry.timestamp = std::time(nullptr);
-                        entry.malId = info.malId;
-                        m_malIdCache[cacheKey] = entry;
-                    }
-                }
-            }
-            catch (const std::exception &e)
-            {
-                LOG_ERROR("Plex", "Error parsing Jikan API response: " + std::string(e.what()));
-            }
+        if (auto cached = m_malIdCache.get(query))
+        {
+            LOG_DEBUG("Plex", "Using cached MAL ID for: " + query);
+            return *cached;
         }
-        else
+
+        // Failed requests aren't cached, so a later notification retries them
+        std::string malId;
+        if (!fetchMALId(query, malId))
+        {
+            return malId;
+        }
+
+        // Jikan found no match: remember that briefly (in memory only) so it isn't asked
+        // again on every notification
+        if (malId.empty())
         {
-            LOG_ERROR("Plex", "Failed to fetch data from Jikan API");
+            m_malIdCache.putUntil(query, malId,
+                                  std::chrono::system_clock::now() + std::chrono::seconds(LOOKUP_MISS_TIMEOUT));
+            return malId;
         }
+
+        m_malIdCache.put(query, malId);
+        persistCacheEntry(MetadataStore::Table::MalId, query, malId, m_malIdCache.ttl());
+        return malId; });
+}
+
+void Plex::loadPersistentCache()
+{
+    if (!Config::getInstance().getPersistentCacheEnabled())
+    {
+        LOG_DEBUG("Plex", "Persistent metadata cache disabled");
+        return;
+    }
+
+    m_metadataStore.load([this](const MetadataStore::Record &record)
+                         {
+        switch (record.table)
+        {
+        case MetadataStore::Table::TmdbArtwork:
+            m_tmdbArtworkCache.putUntil(record.key, record.value, record.expires);
+            break;
+        case MetadataStore::Table::MalId:
+            m_malIdCache.putUntil(record.key, record.value, record.expires);
+            break;
+        } });
+}
+
+void Plex::persistCacheEntry(MetadataStore::Table table, const std::string &key, const std::string &value,
+                             std::chrono::seconds ttl)
+{
+    if (!Config::getInstance().getPersistentCacheEnabled())
+    {
+        return;
     }
+
+    m_metadataStore.append(table, key, value, std::chrono::system_clock::now() + ttl);
 }
 
-void Plex::fetchTMDBArtwork(const std::string &tmdbId, MediaInfo &info)
+bool Plex::fetchMALId(const std::string &query, std::string &malId)
 {
+    malId.clear();
+
+    HttpClient jikanClient;
+    std::string jikanUrl = jikanApiUrl(JIKAN_ANIME_PATH) + "?q=" + urlEncode(query);
+
+    std::string jikanResponse;
+    if (!jikanClient.get(jikanUrl, {}, jikanResponse))
+    {
+        LOG_ERROR("Plex", "Failed to fetch data from Jikan API");
+        return false;
+    }
+
+    try
+    {
+        auto jikanJson = nlohmann::json::parse(jikanResponse);
+        if (jikanJson.contains("data") && !jikanJson["data"].empty())
+        {
+            auto firstResult = jikanJson["data"][0];
+            if (firstResult.contains("mal_id"))
+            {
+                malId = std::to_string(firstResult["mal_id"].get<int>());
+                LOG_INFO("Plex", "Found MyAnimeList ID: " + malId);
+                return true;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR("Plex", "Error parsing Jikan API response: " + std::string(e.what()));
+        return false;
+    }
+
+    LOG_INFO("Plex", "No MyAnimeList match for: " + query);
+    return true;
+}
+
+bool Plex::fetchTMDBArtwork(const std::string &tmdbId, MediaType type, std::string &artPath)
+{
+    artPath.clear();
     LOG_DEBUG("Plex", "Fetching TMDB artwork for ID: " + tmdbId);
 
     // TMDB API requires an access token - get it from config
     std::string accessToken = Config::getInstance().getTMDBAccessToken();
 
+    // Nothing to ask without a token; answered like "no images" so it's only rechecked
+    // after the short miss timeout (e.g. once a token has been configured)
     if (accessToken.empty())
     {
         LOG_INFO("Plex", "No TMDB access token available");
-        return;
+        return true;
     }
 
     // Create HTTP client
@@ -1183,13 +1587,13 @@ void Plex::fetchTMDBArtwork(const std::string &tmdbId, MediaInfo &info)
     std::string url;
 
     // Construct proper endpoint URL based on media type
-    if (info.type == MediaType::Movie)
+    if (type == MediaType::Movie)
     {
-        url = "https://api.themoviedb.org/3/movie/" + tmdbId + "/images";
+        url = tmdbApiUrl("/3/movie/" + tmdbId + "/images");
     }
     else
     {
-        url = "https://api.themoviedb.org/3/tv/" + tmdbId + "/images";
+        url = tmdbApiUrl("/3/tv/" + tmdbId + "/images");
     }
 
     // Set up headers with Bearer token for v4 authentication
@@ -1202,7 +1606,7 @@ void Plex::fetchTMDBArtwork(const std::string &tmdbId, MediaInfo &info)
     if (!client.get(url, headers, response))
     {
         LOG_ERROR("Plex", "Failed to fetch TMDB images");
-        return;
+        return false;
     }
 
     try
@@ -1213,21 +1617,27 @@ void Plex::fetchTMDBArtwork(const std::string &tmdbId, MediaInfo &info)
         if (json.contains("posters") && !json["posters"].empty())
         {
             std::string posterPath = json["posters"][0]["file_path"];
-            info.artPath = std::string(TMDB_IMAGE_BASE_URL) + posterPath;
-            LOG_INFO("Plex", "Found TMDB poster: " + info.artPath);
+            artPath = tmdbImageUrl(posterPath);
+            LOG_INFO("Plex", "Found TMDB poster: " + artPath);
+            return true;
         }
         // Fallback to backdrops
         else if (json.contains("backdrops") && !json["backdrops"].empty())
         {
             std::string backdropPath = json["backdrops"][0]["file_path"];
-            info.artPath = std::string(TMDB_IMAGE_BASE_URL) + backdropPath;
-            LOG_INFO("Plex", "Found TMDB backdrop: " + info.artPath);
+            artPath = tmdbImageUrl(backdropPath);
+            LOG_INFO("Plex", "Found TMDB backdrop: " + artPath);
+            return true;
         }
     }
     catch (const std::exception &e)
     {
         LOG_ERROR("Plex", "Error parsing TMDB response: " + std::string(e.what()));
+        return false;
     }
+
+    LOG_INFO("Plex", "No TMDB images for ID: " + tmdbId);
+    return true;
 }
 
 MediaInfo Plex::getCurrentPlayback()
@@ -1241,7 +1651,11 @@ MediaInfo Plex::getCurrentPlayback()
     }
 
     std::lock_guard<std::mutex> lock(m_sessionMutex);
+    return selectCurrentSession();
+}
 
+MediaInfo Plex::selectCurrentSession()
+{
     // If no active sessions, return stopped state
     if (m_activeSessions.empty())
     {
@@ -1251,9 +1665,8 @@ MediaInfo Plex::getCurrentPlayback()
         return info;
     }
 
-    // Find the oldest playing/paused/buffering session
-    MediaInfo newest;
-    time_t newestTime = (std::numeric_limits<time_t>::min)();
+    // Find the newest playing/paused/buffering session
+    const MediaInfo *newest = nullptr;
 
     for (const auto &[key, info] : m_activeSessions)
     {
@@ -1261,16 +1674,14 @@ MediaInfo Plex::getCurrentPlayback()
             info.state == PlaybackState::Paused ||
             info.state == PlaybackState::Buffering)
         {
-
-            if (info.startTime > newestTime)
+            if (!newest || info.startTime > newest->startTime)
             {
-                newest = info;
-                newestTime = info.startTime;
+                newest = &info;
             }
         }
     }
 
-    if (newestTime == (std::numeric_limits<time_t>::min)())
+    if (!newest)
     {
         // No playing/paused/buffering sessions
         LOG_DEBUG("Plex", "No active playing sessions");
@@ -1279,37 +1690,97 @@ MediaInfo Plex::getCurrentPlayback()
         return info;
     }
 
-    LOG_DEBUG("Plex", "Returning playback info for: " + newest.title + " (" + std::to_string(static_cast<int>(newest.state)) + ")");
-    return newest;
+    LOG_DEBUG("Plex", "Returning playback info for: " + newest->title + " (" + std::to_string(static_cast<int>(newest->state)) + ")");
+    return *newest;
 }
 
-void Plex::stop()
+void Plex::setPlaybackChangedCallback(PlaybackChangedCallback callback)
 {
-    LOG_INFO("Plex", "Stopping all Plex connections");
+    m_playbackChangedCallback = callback;
+}
 
-    m_shuttingDown = true;
+bool Plex::isSamePlayback(const MediaInfo &a, const MediaInfo &b)
+{
+    return a.state == b.state &&
+           a.sessionKey == b.sessionKey &&
+           a.serverId == b.serverId &&
+           a.title == b.title &&
+           a.artPath == b.artPath &&
+           a.malId == b.malId &&
+           a.imdbId == b.imdbId &&
+           a.enrichmentPending() == b.enrichmentPending() &&
+           std::abs(static_cast<long long>(a.startTime - b.startTime)) <= PLAYBACK_DRIFT_TOLERANCE;
+}
 
-    // Stop all SSE connections with a very short timeout since we're shutting down
-    for (auto &[id, server] : Config::getInstance().getPlexServers())
+bool Plex::isSameMedia(const MediaInfo &a, const MediaInfo &b)
+{
+    return a.serverId == b.serverId &&
+           a.type == b.type &&
+           a.title == b.title &&
+           a.grandparentTitle == b.grandparentTitle &&
+           a.season == b.season &&
+           a.episode == b.episode;
+}
+
+void Plex::publishPlaybackIfChanged()
+{
+    bool changed = false;
     {
-        if (server->httpClient)
+        std::lock_guard<std::mutex> lock(m_sessionMutex);
+
+        MediaInfo current;
+        if (m_initialized)
         {
-            LOG_INFO("Plex", "Stopping SSE connection for server: " + server->name);
-            server->running = false;
+            current = selectCurrentSession();
+        }
+        else
+        {
+            current.state = PlaybackState::NotInitialized;
+        }
 
-            // Explicitly reset the client to ensure destruction
-            server->httpClient.reset();
+        if (!isSamePlayback(current, m_lastPublished))
+        {
+            m_lastPublished = current;
+            changed = true;
         }
     }
 
-    // Clear any cached data
-    std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
-    m_tmdbArtworkCache.clear();
-    m_malIdCache.clear();
-    m_mediaInfoCache.clear();
+    if (changed && m_playbackChangedCallback)
+    {
+        LOG_DEBUG("Plex", "Current playback changed, notifying subscriber");
+        m_playbackChangedCallback();
+    }
+}
+
+void Plex::stop()
+{
+    LOG_INFO("Plex", "Stopping all Plex connections");
+
+    {
+        std::lock_guard<std::mutex> lock(m_shutdownMutex);
+        m_shuttingDown = true;
+        m_shutdownCv.notify_all();
+    }
+
+    // Cancel every SSE connection in one go, then let in-flight enrichment finish
+    m_sseReactor.stop();
+    m_workPool.stop();
+    for (auto &[id, server] : Config::getInstance().getPlexServers())
+    {
+        server->running = false;
+    }
+
+    // Metadata caches survive a restart of the connection (e.g. a Discord reconnect);
+    // only drop what depends on the network path and active sessions
+    logCacheStats("TMDB artwork", m_tmdbArtworkCache);
+    logCacheStats("MAL ID", m_malIdCache);
+    logCacheStats("Media info", m_mediaInfoCache);
+    logCacheStats("Session user", m_sessionUserCache);
+    logCacheStats("Server URI", m_serverUriCache);
     m_sessionUserCache.clear();
     m_serverUriCache.clear();
 
     m_initialized = false;
+    publishPlaybackIfChanged();
     LOG_INFO("Plex", "All Plex connections stopped");
 }
@@ -0,0 +1,253 @@
+#include "plex_sax.h"
+
+//
+// PlexSaxHandler
+//
+
+bool PlexSaxHandler::null()
+{
+    return scalar(nullptr);
+}
+
+bool PlexSaxHandler::boolean(bool val)
+{
+    return scalar(val);
+}
+
+bool PlexSaxHandler::number_integer(number_integer_t val)
+{
+    return scalar(val);
+}
+
+bool PlexSaxHandler::number_unsigned(number_unsigned_t val)
+{
+    return scalar(val);
+}
+
+bool PlexSaxHandler::number_float(number_float_t val, const string_t &s)
+{
+    return scalar(val);
+}
+
+bool PlexSaxHandler::string(string_t &val)
+{
+    return scalar(std::move(val));
+}
+
+bool PlexSaxHandler::binary(binary_t &val)
+{
+    // Not produced by the JSON text parser
+    return true;
+}
+
+bool PlexSaxHandler::start_object(std::size_t elements)
+{
+    return beginContainer(false);
+}
+
+bool PlexSaxHandler::key(string_t &val)
+{
+    m_key = std::move(val);
+    return true;
+}
+
+bool PlexSaxHandler::end_object()
+{
+    bool keepGoing = onObjectEnd();
+    m_stack.pop_back();
+    return keepGoing;
+}
+
+bool PlexSaxHandler::start_array(std::size_t elements)
+{
+    return beginContainer(true);
+}
+
+bool PlexSaxHandler::end_array()
+{
+    m_stack.pop_back();
+    return true;
+}
+
+bool PlexSaxHandler::parse_error(std::size_t position, const std::string &last_token,
+                                 const nlohmann::detail::exception &ex)
+{
+    m_error = ex.what();
+    return false;
+}
+
+bool PlexSaxHandler::inMetadataItem(size_t extra) const
+{
+    return m_stack.size() == ITEM_DEPTH + extra &&
+           m_stack[1].key == "MediaContainer" &&
+           m_stack[2].key == "Metadata" && m_stack[2].array;
+}
+
+const std::string &PlexSaxHandler::parentKey(size_t levelsUp) const
+{
+    static const std::string empty;
+    if (levelsUp >= m_stack.size())
+    {
+        return empty;
+    }
+    return m_stack[m_stack.size() - 1 - levelsUp].key;
+}
+
+bool PlexSaxHandler::beginContainer(bool array)
+{
+    bool parentIsArray = m_stack.empty() || m_stack.back().array;
+    m_stack.push_back(Frame{parentIsArray ? std::string() : m_key, array});
+    return true;
+}
+
+bool PlexSaxHandler::scalar(nlohmann::json &&value)
+{
+    // Array elements have no key of their own; nothing we extract lives there
+    if (m_stack.empty() || m_stack.back().array || !wantsValue())
+    {
+        return true;
+    }
+    return onValue(std::move(value));
+}
+
+//
+// SessionListExtractor
+//
+
+SessionListExtractor::SessionListExtractor(std::vector<Session> &sessions) : m_sessions(sessions)
+{
+}
+
+void SessionListExtractor::collect(const std::string &json, std::vector<Session> &sessions)
+{
+    SessionListExtractor handler(sessions);
+    if (!nlohmann::json::sax_parse(json, &handler))
+    {
+        throw std::runtime_error(handler.error());
+    }
+}
+
+bool SessionListExtractor::wantsValue() const
+{
+    if (inMetadataItem())
+    {
+        return m_key == "sessionKey" || m_key == "key" || m_key == "viewOffset";
+    }
+    if (inMetadataItem(1))
+    {
+        return (m_key == "title" && parentKey() == "User") || (m_key == "state" && parentKey() == "Player");
+    }
+    return false;
+}
+
+bool SessionListExtractor::onValue(nlohmann::json &&value)
+{
+    if (m_key == "viewOffset")
+    {
+        m_item.viewOffset = value.is_number() ? value.get<int64_t>() : 0;
+        return true;
+    }
+
+    std::string text = value.is_string() ? value.get<std::string>() : value.dump();
+    if (m_key == "sessionKey")
+    {
+        m_item.sessionKey = std::move(text);
+    }
+    else if (m_key == "key")
+    {
+        m_item.mediaKey = std::move(text);
+    }
+    else if (m_key == "title")
+    {
+        m_item.username = std::move(text);
+    }
+    else
+    {
+        m_item.state = std::move(text);
+    }
+    return true;
+}
+
+bool SessionListExtractor::onObjectEnd()
+{
+    if (!inMetadataItem())
+    {
+        return true;
+    }
+
+    // End of a session item: record it and reset for the next one
+    if (!m_item.sessionKey.empty())
+    {
+        m_sessions.push_back(std::move(m_item));
+    }
+    m_item = Session();
+    return true;
+}
+
+//
+// MetadataExtractor
+//
+
+MetadataExtractor::MetadataExtractor(nlohmann::json &metadata) : m_metadata(metadata)
+{
+}
+
+bool MetadataExtractor::extractFirst(const std::string &json, nlohmann::json &metadata)
+{
+    metadata = nlohmann::json::object();
+
+    MetadataExtractor handler(metadata);
+    bool completed = nlohmann::json::sax_parse(json, &handler);
+    if (!completed && !handler.error().empty())
+    {
+        throw std::runtime_error(handler.error());
+    }
+    return handler.m_found;
+}
+
+bool MetadataExtractor::wantsValue() const
+{
+    if (inMetadataItem())
+    {
+        return true;
+    }
+
+    // Guid[].id and Genre[].tag
+    if (inMetadataItem(2))
+    {
+        const std::string &array = parentKey(1);
+        return (array == "Guid" && m_key == "id") || (array == "Genre" && m_key == "tag");
+    }
+    return false;
+}
+
+bool MetadataExtractor::onValue(nlohmann::json &&value)
+{
+    if (inMetadataItem())
+    {
+        m_metadata[m_key] = std::move(value);
+    }
+    else
+    {
+        m_child[m_key] = std::move(value);
+    }
+    return true;
+}
+
+bool MetadataExtractor::onObjectEnd()
+{
+    if (inMetadataItem(2) && !m_child.is_null())
+    {
+        m_metadata[parentKey(1)].push_back(std::move(m_child));
+        m_child = nullptr;
+        return true;
+    }
+
+    if (inMetadataItem())
+    {
+        // Only the first item is needed
+        m_found = true;
+        return false;
+    }
+    return true;
+}
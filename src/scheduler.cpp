@@ -0,0 +1,259 @@
+#include "scheduler.h"
+
+namespace
+{
+    constexpr std::chrono::milliseconds TICK(10);
+    constexpr uint64_t NO_TICK = UINT64_MAX;
+}
+
+Scheduler &Scheduler::getInstance()
+{
+    static Scheduler instance;
+    return instance;
+}
+
+Scheduler::Scheduler() : m_epoch(Clock::now())
+{
+}
+
+Scheduler::~Scheduler()
+{
+    shutdown();
+}
+
+Scheduler::TaskId Scheduler::schedule(std::chrono::milliseconds delay, Task task)
+{
+    auto deadline = Clock::now() + (std::max)(delay, std::chrono::milliseconds(0));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running)
+    {
+        // Started lazily so an idle process has no timer thread at all
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+        m_running = true;
+        m_thread = std::thread(&Scheduler::timerLoop, this);
+    }
+
+    TaskId id = m_nextId++;
+    uint64_t expires = (std::max)(tickAt(deadline, true), m_currentTick + 1);
+
+    Slot incoming;
+    incoming.push_back(Timer{id, expires, std::move(task)});
+    place(incoming, incoming.begin());
+
+    // Only disturb the timer thread if it is asleep past the new deadline
+    if (expires < m_wakeTick)
+    {
+        m_cv.notify_all();
+    }
+    return id;
+}
+
+bool Scheduler::cancel(TaskId id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(id);
+    if (it != m_index.end())
+    {
+        it->second.slot->erase(it->second.it);
+        m_index.erase(it);
+        return true;
+    }
+
+    if (std::this_thread::get_id() != m_thread.get_id())
+    {
+        m_cv.wait(lock, [this, id]
+                  { return m_runningId != id; });
+    }
+    return false;
+}
+
+void Scheduler::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        for (auto &level : m_wheel)
+        {
+            for (auto &slot : level)
+            {
+                slot.clear();
+            }
+        }
+        m_index.clear();
+    }
+    m_cv.notify_all();
+
+    if (m_thread.joinable() && std::this_thread::get_id() != m_thread.get_id())
+    {
+        m_thread.join();
+    }
+}
+
+Scheduler::Stats Scheduler::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.pending = m_index.size();
+    return stats;
+}
+
+uint64_t Scheduler::tickAt(Clock::time_point time, bool roundUp) const
+{
+    if (time <= m_epoch)
+    {
+        return 0;
+    }
+
+    // Deadlines round up and the current time rounds down, so a timer never fires early
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(time - m_epoch).count();
+    auto tick = std::chrono::duration_cast<std::chrono::microseconds>(TICK).count();
+    return static_cast<uint64_t>((elapsed + (roundUp ? tick - 1 : 0)) / tick);
+}
+
+Scheduler::Clock::time_point Scheduler::timeOf(uint64_t tick) const
+{
+    return m_epoch + TICK * static_cast<int64_t>(tick);
+}
+
+void Scheduler::place(Slot &from, Slot::iterator it)
+{
+    // A timer cascading down on its own tick lands in the current level 0 slot
+    uint64_t expires = (std::max)(it->expires, m_currentTick);
+    uint64_t delta = expires - m_currentTick;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1))))
+    {
+        level++;
+    }
+
+    // Beyond the wheel's range: park in the furthest slot and re-place when it cascades
+    uint64_t maxDelta = (1ull << (SLOT_BITS * LEVELS)) - 1;
+    if (delta > maxDelta)
+    {
+        expires = m_currentTick + maxDelta;
+    }
+
+    Slot &slot = m_wheel[level][(expires >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    slot.splice(slot.end(), from, it);
+    m_index[it->id] = Location{&slot, it};
+}
+
+void Scheduler::cascade(int level)
+{
+    Slot &slot = m_wheel[level][(m_currentTick >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    Slot moving;
+    moving.splice(moving.end(), slot);
+    while (!moving.empty())
+    {
+        place(moving, moving.begin());
+    }
+}
+
+void Scheduler::runDue()
+{
+    Slot &slot = m_wheel[0][m_currentTick & (SLOTS - 1)];
+    while (!slot.empty() && m_running)
+    {
+        Timer timer = std::move(slot.front());
+        slot.pop_front();
+        m_index.erase(timer.id);
+        m_runningId = timer.id;
+
+        m_mutex.unlock();
+        try
+        {
+            timer.task();
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("Scheduler", "Exception in scheduled task: " + std::string(e.what()));
+        }
+        m_mutex.lock();
+
+        m_runningId = 0;
+        m_stats.fired++;
+        m_cv.notify_all();
+    }
+}
+
+bool Scheduler::nextEventTick(uint64_t &tick) const
+{
+    bool found = false;
+    tick = NO_TICK;
+
+    // Level 0 slots expire on their own tick; higher levels matter at the tick where
+    // their slot cascades down
+    for (int level = 0; level < LEVELS; level++)
+    {
+        int shift = SLOT_BITS * level;
+        uint64_t block = m_currentTick >> shift;
+        for (uint64_t k = 1; k <= SLOTS; k++)
+        {
+            uint64_t candidate = (block + k) << shift;
+            if (found && candidate >= tick)
+            {
+                break;
+            }
+            if (!m_wheel[level][(block + k) & (SLOTS - 1)].empty())
+            {
+                tick = candidate;
+                found = true;
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+void Scheduler::timerLoop()
+{
+    LOG_DEBUG("Scheduler", "Timer thread started");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running)
+    {
+        // Catch up on every tick that has work, jumping over the empty ones
+        uint64_t now = tickAt(Clock::now(), false);
+        uint64_t next;
+        while (m_running && nextEventTick(next) && next <= now)
+        {
+            m_currentTick = next;
+            for (int level = 1; level < LEVELS; level++)
+            {
+                if (m_currentTick & ((1ull << (SLOT_BITS * level)) - 1))
+                {
+                    break;
+                }
+                cascade(level);
+            }
+            runDue();
+        }
+        if (!m_running)
+        {
+            break;
+        }
+        m_currentTick = (std::max)(m_currentTick, now);
+
+        // Sleep until the next tick that needs attention (or indefinitely if none)
+        if (nextEventTick(next))
+        {
+            m_wakeTick = next;
+            m_cv.wait_until(lock, timeOf(next));
+        }
+        else
+        {
+            m_wakeTick = NO_TICK;
+            m_cv.wait(lock);
+        }
+        m_wakeTick = NO_TICK;
+        m_stats.wakeups++;
+    }
+
+    LOG_DEBUG("Scheduler", "Timer thread stopped");
+}
@@ -0,0 +1,236 @@
+#include "sse_parser.h"
+
+namespace
+{
+    // Largest event we are willing to buffer; anything bigger is dropped
+    constexpr size_t MAX_EVENT_SIZE = 1024 * 1024;
+
+    const std::string_view DEFAULT_EVENT_TYPE = "message";
+}
+
+SSEParser::SSEParser(EventHandler handler) : m_handler(std::move(handler))
+{
+}
+
+void SSEParser::feed(const char *data, size_t size)
+{
+    if (m_skipLeadingLF && size > 0)
+    {
+        m_skipLeadingLF = false;
+        if (data[0] == '\n')
+        {
+            data++;
+            size--;
+        }
+    }
+    if (size == 0)
+    {
+        return;
+    }
+
+    compact();
+    m_buffer.insert(m_buffer.end(), data, data + size);
+
+    while (true)
+    {
+        size_t lineEnd = findLineEnd(m_scanPos);
+        if (lineEnd == std::string::npos)
+        {
+            m_scanPos = m_buffer.size();
+            break;
+        }
+
+        processLine(m_readPos, lineEnd);
+
+        size_t next = lineEnd + 1;
+        if (m_buffer[lineEnd] == '\r')
+        {
+            if (next < m_buffer.size())
+            {
+                if (m_buffer[next] == '\n')
+                {
+                    next++;
+                }
+            }
+            else
+            {
+                // The matching LF (if any) arrives with the next chunk
+                m_skipLeadingLF = true;
+            }
+        }
+        m_readPos = m_scanPos = next;
+    }
+
+    // Guard against a peer that never terminates a line or an event
+    size_t retainedFrom = (m_dataLines == 1) ? std::min(m_dataOffset, m_readPos) : m_readPos;
+    if (m_buffer.size() - retainedFrom > MAX_EVENT_SIZE || m_data.size() > MAX_EVENT_SIZE)
+    {
+        resetEvent();
+        m_discarding = true;
+        m_readPos = m_scanPos = m_buffer.size();
+    }
+}
+
+void SSEParser::reset()
+{
+    m_buffer.clear();
+    m_readPos = 0;
+    m_scanPos = 0;
+    m_skipLeadingLF = false;
+    m_discarding = false;
+    m_pendingEventId = m_lastEventId;
+    resetEvent();
+}
+
+size_t SSEParser::findLineEnd(size_t from) const
+{
+    size_t remaining = m_buffer.size() - from;
+    if (remaining == 0)
+    {
+        return std::string::npos;
+    }
+
+    const char *begin = m_buffer.data() + from;
+    const char *lf = static_cast<const char *>(std::memchr(begin, '\n', remaining));
+
+    // A CR only matters if it comes before the next LF
+    size_t crLimit = lf ? static_cast<size_t>(lf - begin) : remaining;
+    const char *cr = static_cast<const char *>(std::memchr(begin, '\r', crLimit));
+
+    const char *end = cr ? cr : lf;
+    return end ? static_cast<size_t>(end - m_buffer.data()) : std::string::npos;
+}
+
+void SSEParser::processLine(size_t start, size_t end)
+{
+    if (start == end)
+    {
+        // Blank line: end of event
+        if (m_discarding)
+        {
+            // The dropped event's ID is dropped with it
+            m_discarding = false;
+            m_pendingEventId = m_lastEventId;
+            resetEvent();
+        }
+        else
+        {
+            dispatch();
+        }
+        return;
+    }
+
+    if (m_discarding || m_buffer[start] == ':')
+    {
+        // Comment (or the rest of an oversized event)
+        return;
+    }
+
+    std::string_view line(m_buffer.data() + start, end - start);
+    std::string_view field = line;
+    std::string_view value;
+    size_t colon = line.find(':');
+    if (colon != std::string_view::npos)
+    {
+        field = line.substr(0, colon);
+        value = line.substr(colon + 1);
+        if (!value.empty() && value.front() == ' ')
+        {
+            value.remove_prefix(1);
+        }
+    }
+
+    if (field == "data")
+    {
+        if (m_dataLines == 0)
+        {
+            m_dataOffset = static_cast<size_t>(value.data() - m_buffer.data());
+            m_dataSize = value.size();
+        }
+        else
+        {
+            if (m_dataLines == 1)
+            {
+                m_data.assign(m_buffer.data() + m_dataOffset, m_dataSize);
+            }
+            m_data.push_back('\n');
+            m_data.append(value);
+        }
+        m_dataLines++;
+    }
+    else if (field == "event")
+    {
+        m_eventType.assign(value);
+    }
+    else if (field == "id")
+    {
+        if (value.find('\0') == std::string_view::npos)
+        {
+            m_pendingEventId.assign(value);
+        }
+    }
+    else if (field == "retry")
+    {
+        if (!value.empty() && value.size() <= 18 &&
+            value.find_first_not_of("0123456789") == std::string_view::npos)
+        {
+            m_retryMs = std::stoll(std::string(value));
+        }
+    }
+}
+
+void SSEParser::dispatch()
+{
+    // The ID is committed even when there is no data to deliver, as the spec requires
+    m_lastEventId = m_pendingEventId;
+
+    if (m_dataLines == 0)
+    {
+        resetEvent();
+        return;
+    }
+
+    SSEEvent event;
+    event.type = m_eventType.empty() ? DEFAULT_EVENT_TYPE : std::string_view(m_eventType);
+    event.data = m_dataLines == 1 ? std::string_view(m_buffer.data() + m_dataOffset, m_dataSize)
+                                  : std::string_view(m_data);
+    event.id = m_lastEventId;
+
+    if (m_handler)
+    {
+        m_handler(event);
+    }
+    resetEvent();
+}
+
+void SSEParser::resetEvent()
+{
+    m_dataLines = 0;
+    m_dataOffset = 0;
+    m_dataSize = 0;
+    m_data.clear();
+    m_eventType.clear();
+}
+
+void SSEParser::compact()
+{
+    // Bytes before keepFrom are no longer referenced (a lone pending data line still is)
+    size_t keepFrom = m_readPos;
+    if (m_dataLines == 1 && m_dataOffset < keepFrom)
+    {
+        keepFrom = m_dataOffset;
+    }
+
+    if (keepFrom == 0 || keepFrom < m_buffer.size() / 2)
+    {
+        return;
+    }
+
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(keepFrom));
+    m_readPos -= keepFrom;
+    m_scanPos -= keepFrom;
+    if (m_dataLines == 1)
+    {
+        m_dataOffset -= keepFrom;
+    }
+}
@@ -0,0 +1,678 @@
+#include "sse_reactor.h"
+#include "http_client.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr int MAX_EPOLL_EVENTS = 32;
+    constexpr int IDLE_POLL_TIMEOUT_MS = 60000;
+
+    // Default idle window; Plex pings well within this
+    constexpr long long DEFAULT_IDLE_TIMEOUT_SECONDS = 90;
+
+    // TCP keepalive probes so the kernel also notices dead peers
+    constexpr long TCP_KEEPALIVE_IDLE_SECONDS = 30;
+    constexpr long TCP_KEEPALIVE_INTERVAL_SECONDS = 10;
+}
+
+SSEReactor::SSEReactor() : m_idleTimeoutSeconds(DEFAULT_IDLE_TIMEOUT_SECONDS)
+{
+    curl_global_init(CURL_GLOBAL_ALL);
+    m_multi = curl_multi_init();
+
+#ifdef __linux__
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd == -1 || m_wakeFd == -1)
+    {
+        LOG_ERROR("SSEReactor", "Failed to create epoll/eventfd: " + std::string(strerror(errno)));
+    }
+    else
+    {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = m_wakeFd;
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+    }
+
+    curl_multi_setopt(m_multi, CURLMOPT_SOCKETFUNCTION, socketCallback);
+    curl_multi_setopt(m_multi, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(m_multi, CURLMOPT_TIMERFUNCTION, timerCallback);
+    curl_multi_setopt(m_multi, CURLMOPT_TIMERDATA, this);
+#endif
+
+    LOG_DEBUG("SSEReactor", "SSEReactor initialized");
+}
+
+SSEReactor::~SSEReactor()
+{
+    stop();
+
+    if (m_multi)
+    {
+        curl_multi_cleanup(m_multi);
+        m_multi = nullptr;
+    }
+
+#ifdef __linux__
+    if (m_wakeFd != -1)
+    {
+        close(m_wakeFd);
+    }
+    if (m_epollFd != -1)
+    {
+        close(m_epollFd);
+    }
+#endif
+
+    curl_global_cleanup();
+    LOG_DEBUG("SSEReactor", "SSEReactor object destroyed");
+}
+
+bool SSEReactor::start()
+{
+    if (m_running)
+    {
+        return true;
+    }
+
+    if (!m_multi)
+    {
+        LOG_ERROR("SSEReactor", "CURL multi handle not initialized");
+        return false;
+    }
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    m_running = true;
+    m_thread = std::thread(&SSEReactor::eventLoop, this);
+    LOG_INFO("SSEReactor", "SSE event loop started");
+    return true;
+}
+
+void SSEReactor::stop()
+{
+    if (m_running.exchange(false))
+    {
+        LOG_INFO("SSEReactor", "Requesting termination of all SSE connections");
+        wakeup();
+    }
+
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+        LOG_INFO("SSEReactor", "SSE event loop stopped");
+    }
+}
+
+bool SSEReactor::addStream(const std::string &id, const std::string &url,
+                           const std::map<std::string, std::string> &headers,
+                           EventCallback callback,
+                           ReconnectCallback reconnectCallback)
+{
+    auto stream = std::make_unique<Stream>();
+    stream->id = id;
+    stream->url = url;
+    stream->headers = headers;
+    stream->callback = std::move(callback);
+    stream->reconnectCallback = std::move(reconnectCallback);
+    stream->nextAttempt = std::chrono::steady_clock::now();
+    stream->lastByte = stream->nextAttempt;
+
+    Stream *raw = stream.get();
+    stream->parser = std::make_unique<SSEParser>([raw](const SSEEvent &event)
+                                                 {
+        if (!raw->callback)
+        {
+            return;
+        }
+
+        // Never let an exception unwind through libcurl
+        try
+        {
+            raw->callback(event);
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("SSEReactor", "Exception in SSE event callback: " + std::string(e.what()));
+        } });
+
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingChanges.push_back({id, std::move(stream)});
+    }
+
+    LOG_INFO_STREAM("SSEReactor", "Registered SSE stream " << id << ": " << url);
+    wakeup();
+    return true;
+}
+
+void SSEReactor::removeStream(const std::string &id)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingChanges.push_back({id, nullptr});
+    }
+    wakeup();
+}
+
+void SSEReactor::setIdleTimeout(std::chrono::seconds timeout)
+{
+    m_idleTimeoutSeconds = timeout.count();
+    wakeup();
+}
+
+std::vector<SSEReactor::StreamStatus> SSEReactor::getStreamStatus() const
+{
+    auto now = std::chrono::steady_clock::now();
+    std::vector<StreamStatus> result;
+
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    for (const auto &[id, entry] : m_status)
+    {
+        result.push_back({id, entry.connected,
+                          std::chrono::duration_cast<std::chrono::milliseconds>(now - entry.lastByte)});
+    }
+    return result;
+}
+
+void SSEReactor::wakeup()
+{
+#ifdef __linux__
+    uint64_t one = 1;
+    if (write(m_wakeFd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+    {
+        LOG_WARNING("SSEReactor", "Failed to wake event loop: " + std::string(strerror(errno)));
+    }
+#else
+    curl_multi_wakeup(m_multi);
+#endif
+}
+
+void SSEReactor::applyPendingChanges()
+{
+    std::vector<PendingChange> changes;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        changes.swap(m_pendingChanges);
+    }
+
+    for (auto &change : changes)
+    {
+        auto it = m_streams.find(change.id);
+        if (it != m_streams.end())
+        {
+            destroyStream(*it->second);
+            m_streams.erase(it);
+            LOG_DEBUG("SSEReactor", "Removed SSE stream " + change.id);
+        }
+
+        if (change.stream)
+        {
+            m_streams[change.id] = std::move(change.stream);
+        }
+    }
+}
+
+void SSEReactor::connectDueStreams()
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto &[id, stream] : m_streams)
+    {
+        if (!stream->active && stream->nextAttempt <= now && !connectStream(*stream))
+        {
+            scheduleReconnect(*stream, true);
+        }
+    }
+}
+
+int SSEReactor::nextTimeoutMs() const
+{
+    auto now = std::chrono::steady_clock::now();
+    bool hasDeadline = false;
+    std::chrono::steady_clock::time_point deadline;
+
+    auto idleTimeout = std::chrono::seconds(m_idleTimeoutSeconds.load());
+    for (const auto &[id, stream] : m_streams)
+    {
+        std::chrono::steady_clock::time_point streamDeadline;
+        if (!stream->active)
+        {
+            streamDeadline = stream->nextAttempt;
+        }
+        else if (idleTimeout.count() > 0)
+        {
+            streamDeadline = stream->lastByte + idleTimeout;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (!hasDeadline || streamDeadline < deadline)
+        {
+            deadline = streamDeadline;
+            hasDeadline = true;
+        }
+    }
+
+#ifdef __linux__
+    if (m_curlTimerArmed && (!hasDeadline || m_curlDeadline < deadline))
+    {
+        deadline = m_curlDeadline;
+        hasDeadline = true;
+    }
+#endif
+
+    if (!hasDeadline)
+    {
+        return -1;
+    }
+    if (deadline <= now)
+    {
+        return 0;
+    }
+
+    // Round up so we never wake just before the deadline and spin
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+    return static_cast<int>((std::min<long long>)(remaining, IDLE_POLL_TIMEOUT_MS));
+}
+
+bool SSEReactor::connectStream(Stream &stream)
+{
+    if (!stream.easy)
+    {
+        stream.easy = curl_easy_init();
+        if (!stream.easy)
+        {
+            LOG_ERROR("SSEReactor", "Failed to initialize CURL for SSE connection " + stream.id);
+            return false;
+        }
+    }
+    else
+    {
+        curl_easy_reset(stream.easy);
+    }
+
+    if (stream.headerList)
+    {
+        curl_slist_free_all(stream.headerList);
+        stream.headerList = nullptr;
+    }
+    for (const auto &[key, value] : stream.headers)
+    {
+        std::string header = key + ": " + value;
+        stream.headerList = curl_slist_append(stream.headerList, header.c_str());
+    }
+    stream.headerList = curl_slist_append(stream.headerList, "Accept: text/event-stream");
+    if (!stream.parser->lastEventId().empty())
+    {
+        // Ask the server to replay anything we missed while disconnected
+        std::string header = "Last-Event-ID: " + stream.parser->lastEventId();
+        stream.headerList = curl_slist_append(stream.headerList, header.c_str());
+    }
+
+    curl_easy_setopt(stream.easy, CURLOPT_URL, stream.url.c_str());
+    curl_easy_setopt(stream.easy, CURLOPT_HTTPHEADER, stream.headerList);
+    curl_easy_setopt(stream.easy, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(stream.easy, CURLOPT_WRITEDATA, &stream);
+    curl_easy_setopt(stream.easy, CURLOPT_HEADERFUNCTION, headerCallback);
+    curl_easy_setopt(stream.easy, CURLOPT_HEADERDATA, &stream);
+    curl_easy_setopt(stream.easy, CURLOPT_PRIVATE, &stream);
+    curl_easy_setopt(stream.easy, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(stream.easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(stream.easy, CURLOPT_TCP_KEEPIDLE, TCP_KEEPALIVE_IDLE_SECONDS);
+    curl_easy_setopt(stream.easy, CURLOPT_TCP_KEEPINTVL, TCP_KEEPALIVE_INTERVAL_SECONDS);
+    HttpConnectionPool::getInstance().attachShare(stream.easy);
+
+    stream.parser->reset();
+
+    CURLMcode mc = curl_multi_add_handle(m_multi, stream.easy);
+    if (mc != CURLM_OK)
+    {
+        LOG_ERROR("SSEReactor", "Failed to add SSE connection " + stream.id + ": " + curl_multi_strerror(mc));
+        return false;
+    }
+
+    stream.active = true;
+    stream.lastByte = std::chrono::steady_clock::now();
+    LOG_INFO_STREAM("SSEReactor", "Establishing SSE connection " << stream.id
+                                                                 << ", attempt #" << (stream.retry.attempts() + 1));
+    return true;
+}
+
+void SSEReactor::disconnectStream(Stream &stream)
+{
+    if (stream.active)
+    {
+        curl_multi_remove_handle(m_multi, stream.easy);
+        stream.active = false;
+    }
+}
+
+void SSEReactor::destroyStream(Stream &stream)
+{
+    disconnectStream(stream);
+
+    if (stream.easy)
+    {
+        curl_easy_cleanup(stream.easy);
+        stream.easy = nullptr;
+    }
+    if (stream.headerList)
+    {
+        curl_slist_free_all(stream.headerList);
+        stream.headerList = nullptr;
+    }
+}
+
+void SSEReactor::scheduleReconnect(Stream &stream, bool failed)
+{
+    std::chrono::milliseconds delay(0);
+    if (failed)
+    {
+        delay = stream.retry.nextDelay();
+    }
+    else
+    {
+        stream.retry.reset();
+    }
+
+    // The server's retry: field sets the minimum reconnection delay
+    if (stream.parser->retryMs() >= 0)
+    {
+        delay = (std::max)(delay, std::chrono::milliseconds(stream.parser->retryMs()));
+    }
+
+    LOG_DEBUG_STREAM("SSEReactor", "Reconnecting SSE connection " << stream.id << " in " << delay.count() << " ms");
+    stream.nextAttempt = std::chrono::steady_clock::now() + delay;
+}
+
+void SSEReactor::processCompletedTransfers()
+{
+    CURLMsg *msg;
+    int remaining = 0;
+    while ((msg = curl_multi_info_read(m_multi, &remaining)) != nullptr)
+    {
+        if (msg->msg != CURLMSG_DONE)
+        {
+            continue;
+        }
+
+        Stream *stream = nullptr;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char **>(&stream));
+        if (!stream)
+        {
+            continue;
+        }
+
+        CURLcode res = msg->data.result;
+        long responseCode = 0;
+        curl_easy_getinfo(stream->easy, CURLINFO_RESPONSE_CODE, &responseCode);
+        disconnectStream(*stream);
+
+        if (res != CURLE_OK)
+        {
+            LOG_WARNING_STREAM("SSEReactor", "SSE connection " << stream->id << " error: " << curl_easy_strerror(res)
+                                                               << ", retry count: " << (stream->retry.attempts() + 1));
+            scheduleReconnect(*stream, true);
+        }
+        else if (responseCode < 200 || responseCode >= 300)
+        {
+            LOG_WARNING_STREAM("SSEReactor", "SSE connection " << stream->id
+                                                               << " rejected with HTTP status code: " << responseCode);
+            scheduleReconnect(*stream, true);
+        }
+        else
+        {
+            LOG_INFO("SSEReactor", "SSE connection " + stream->id + " ended normally");
+            scheduleReconnect(*stream, false);
+        }
+    }
+}
+
+void SSEReactor::checkIdleStreams()
+{
+    auto now = std::chrono::steady_clock::now();
+    auto idleTimeout = std::chrono::seconds(m_idleTimeoutSeconds.load());
+
+    for (auto &[id, stream] : m_streams)
+    {
+        if (stream->active && idleTimeout.count() > 0 && now - stream->lastByte >= idleTimeout)
+        {
+            // Half-open connection (NAT timeout, sleeping server): nothing will ever arrive
+            LOG_WARNING_STREAM("SSEReactor", "SSE connection " << id << " silent for "
+                                                                << idleTimeout.count() << "s, reconnecting");
+            disconnectStream(*stream);
+            scheduleReconnect(*stream, true);
+        }
+    }
+
+    // Publish health for getStreamStatus()
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    for (auto it = m_status.begin(); it != m_status.end();)
+    {
+        it = m_streams.count(it->first) ? std::next(it) : m_status.erase(it);
+    }
+    for (const auto &[id, stream] : m_streams)
+    {
+        m_status[id] = StatusEntry{stream->active, stream->lastByte};
+    }
+}
+
+size_t SSEReactor::writeCallback(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    Stream *stream = static_cast<Stream *>(userdata);
+    size_t total_size = size * nmemb;
+
+    stream->lastByte = std::chrono::steady_clock::now();
+    LOG_DEBUG_STREAM("SSEReactor", "SSE received " << total_size << " bytes on " << stream->id);
+
+    // Only the new bytes are scanned; completed events go straight to the callback
+    stream->parser->feed(ptr, total_size);
+    return total_size;
+}
+
+size_t SSEReactor::headerCallback(char *buffer, size_t size, size_t nitems, void *userdata)
+{
+    Stream *stream = static_cast<Stream *>(userdata);
+    size_t total_size = size * nitems;
+    stream->lastByte = std::chrono::steady_clock::now();
+
+    // A bare CRLF ends the header block; only a 2xx means the stream is really up
+    bool endOfHeaders = (total_size == 2 && buffer[0] == '\r' && buffer[1] == '\n') ||
+                        (total_size == 1 && buffer[0] == '\n');
+    if (!endOfHeaders)
+    {
+        return total_size;
+    }
+
+    long responseCode = 0;
+    curl_easy_getinfo(stream->easy, CURLINFO_RESPONSE_CODE, &responseCode);
+    if (responseCode < 200 || responseCode >= 300)
+    {
+        return total_size;
+    }
+
+    LOG_INFO("SSEReactor", "SSE connection " + stream->id + " established");
+    stream->retry.reset();
+
+    if (stream->everConnected && stream->reconnectCallback)
+    {
+        try
+        {
+            stream->reconnectCallback();
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("SSEReactor", "Exception in SSE reconnect callback: " + std::string(e.what()));
+        }
+    }
+    stream->everConnected = true;
+    return total_size;
+}
+
+#ifdef __linux__
+int SSEReactor::socketCallback(CURL *easy, curl_socket_t s, int what, void *userp, void *socketp)
+{
+    SSEReactor *reactor = static_cast<SSEReactor *>(userp);
+
+    if (what == CURL_POLL_REMOVE)
+    {
+        epoll_ctl(reactor->m_epollFd, EPOLL_CTL_DEL, s, nullptr);
+        reactor->m_watchedSockets.erase(s);
+        return 0;
+    }
+
+    struct epoll_event ev = {};
+    ev.data.fd = s;
+    if (what & CURL_POLL_IN)
+    {
+        ev.events |= EPOLLIN;
+    }
+    if (what & CURL_POLL_OUT)
+    {
+        ev.events |= EPOLLOUT;
+    }
+
+    bool watched = reactor->m_watchedSockets.count(s) > 0;
+    if (epoll_ctl(reactor->m_epollFd, watched ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, s, &ev) != 0)
+    {
+        LOG_WARNING("SSEReactor", "epoll_ctl failed: " + std::string(strerror(errno)));
+        return -1;
+    }
+    reactor->m_watchedSockets.insert(s);
+    return 0;
+}
+
+int SSEReactor::timerCallback(CURLM *multi, long timeout_ms, void *userp)
+{
+    SSEReactor *reactor = static_cast<SSEReactor *>(userp);
+
+    if (timeout_ms < 0)
+    {
+        reactor->m_curlTimerArmed = false;
+    }
+    else
+    {
+        reactor->m_curlTimerArmed = true;
+        reactor->m_curlDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    }
+    return 0;
+}
+#endif
+
+void SSEReactor::eventLoop()
+{
+    LOG_INFO("SSEReactor", "SSE event loop thread starting");
+
+    try
+    {
+        while (m_running)
+        {
+            applyPendingChanges();
+            connectDueStreams();
+
+            int running = 0;
+#ifdef __linux__
+            struct epoll_event events[MAX_EPOLL_EVENTS];
+            int n = epoll_wait(m_epollFd, events, MAX_EPOLL_EVENTS, nextTimeoutMs());
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                LOG_ERROR("SSEReactor", "epoll_wait failed: " + std::string(strerror(errno)));
+                break;
+            }
+
+            for (int i = 0; i < n; ++i)
+            {
+                if (events[i].data.fd == m_wakeFd)
+                {
+                    uint64_t value;
+                    while (read(m_wakeFd, &value, sizeof(value)) > 0)
+                    {
+                    }
+                    continue;
+                }
+
+                int flags = 0;
+                if (events[i].events & EPOLLIN)
+                {
+                    flags |= CURL_CSELECT_IN;
+                }
+                if (events[i].events & EPOLLOUT)
+                {
+                    flags |= CURL_CSELECT_OUT;
+                }
+                if (events[i].events & (EPOLLERR | EPOLLHUP))
+                {
+                    flags |= CURL_CSELECT_ERR;
+                }
+                curl_multi_socket_action(m_multi, events[i].data.fd, flags, &running);
+            }
+
+            if (m_curlTimerArmed && std::chrono::steady_clock::now() >= m_curlDeadline)
+            {
+                m_curlTimerArmed = false;
+                curl_multi_socket_action(m_multi, CURL_SOCKET_TIMEOUT, 0, &running);
+            }
+#else
+            int timeout = nextTimeoutMs();
+            if (timeout < 0)
+            {
+                timeout = IDLE_POLL_TIMEOUT_MS;
+            }
+
+            CURLMcode mc = curl_multi_poll(m_multi, nullptr, 0, timeout, nullptr);
+            if (mc != CURLM_OK)
+            {
+                LOG_ERROR("SSEReactor", "curl_multi_poll failed: " + std::string(curl_multi_strerror(mc)));
+                break;
+            }
+            curl_multi_perform(m_multi, &running);
+#endif
+
+            processCompletedTransfers();
+            checkIdleStreams();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR("SSEReactor", "Exception in SSE event loop: " + std::string(e.what()));
+    }
+    catch (...)
+    {
+        LOG_ERROR("SSEReactor", "Unknown exception in SSE event loop");
+    }
+
+    // Tear down every stream at once
+    for (auto &[id, stream] : m_streams)
+    {
+        destroyStream(*stream);
+    }
+    m_streams.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pendingChanges.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        m_status.clear();
+    }
+    m_running = false;
+
+    LOG_INFO("SSEReactor", "SSE event loop thread exiting");
+}
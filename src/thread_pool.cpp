@@ -0,0 +1,238 @@
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool(size_t workers, size_t perHostLimit, size_t capacity)
+    : m_workerCount((std::max)(workers, static_cast<size_t>(1))),
+      m_perHostLimit((std::max)(perHostLimit, static_cast<size_t>(1))),
+      m_capacity(capacity)
+{
+}
+
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+bool ThreadPool::start()
+{
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    if (m_running)
+    {
+        return true;
+    }
+
+    {
+        // Forget bookkeeping of tasks that raced with the last stop()
+        std::lock_guard<std::mutex> hostLock(m_hostMutex);
+        m_hosts.clear();
+        m_backlog = 0;
+    }
+
+    m_running = true;
+    m_queued = 0;
+    m_workers.clear();
+    for (size_t i = 0; i < m_workerCount; i++)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < m_workerCount; i++)
+    {
+        m_workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+    }
+
+    LOG_DEBUG("ThreadPool", "Started " + std::to_string(m_workerCount) + " workers");
+    return true;
+}
+
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_wakeCv.notify_all();
+
+    for (auto &worker : m_workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+
+    // Anything still queued is dropped
+    size_t dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_hostMutex);
+        dropped = m_backlog;
+        m_hosts.clear();
+        m_backlog = 0;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_queued = 0;
+        m_workers.clear();
+    }
+
+    LOG_DEBUG("ThreadPool", "Stopped, dropped " + std::to_string(dropped) + " queued tasks");
+}
+
+bool ThreadPool::post(const std::string &host, Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        if (!m_running)
+        {
+            return false;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_hostMutex);
+        if (m_capacity > 0 && m_backlog >= m_capacity)
+        {
+            LOG_WARNING("ThreadPool", "Backlog full, rejecting task for " + host);
+            return false;
+        }
+        m_backlog++;
+
+        HostState &state = m_hosts[host];
+        if (state.active >= m_perHostLimit)
+        {
+            state.waiting.push_back(std::move(task));
+            return true;
+        }
+        state.active++;
+    }
+
+    dispatch(host, std::move(task));
+    return true;
+}
+
+void ThreadPool::dispatch(const std::string &host, Task task)
+{
+    Task wrapped = [this, host, task = std::move(task)]()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_hostMutex);
+            m_backlog--;
+        }
+
+        try
+        {
+            task();
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("ThreadPool", "Exception in task for " + host + ": " + e.what());
+        }
+        catch (...)
+        {
+            LOG_ERROR("ThreadPool", "Unknown exception in task for " + host);
+        }
+
+        finish(host);
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        if (!m_running)
+        {
+            return;
+        }
+
+        Worker &worker = *m_workers[m_nextWorker++ % m_workers.size()];
+        {
+            std::lock_guard<std::mutex> workerLock(worker.mutex);
+            worker.tasks.push_back(std::move(wrapped));
+        }
+        m_queued++;
+    }
+    m_wakeCv.notify_one();
+}
+
+void ThreadPool::finish(const std::string &host)
+{
+    Task next;
+    {
+        std::lock_guard<std::mutex> lock(m_hostMutex);
+        auto it = m_hosts.find(host);
+        if (it == m_hosts.end())
+        {
+            return;
+        }
+
+        HostState &state = it->second;
+        if (state.waiting.empty())
+        {
+            state.active--;
+            if (state.active == 0)
+            {
+                m_hosts.erase(it);
+            }
+            return;
+        }
+
+        // Hand this host's slot straight to its next waiting task
+        next = std::move(state.waiting.front());
+        state.waiting.pop_front();
+    }
+
+    dispatch(host, std::move(next));
+}
+
+ThreadPool::Task ThreadPool::take(size_t index)
+{
+    // The caller has claimed one queued task, so some deque holds one for us; another
+    // worker scanning at the same time may take it first, in which case scan again
+    while (true)
+    {
+        {
+            Worker &own = *m_workers[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                Task task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return task;
+            }
+        }
+
+        for (size_t i = 1; i < m_workers.size(); i++)
+        {
+            Worker &victim = *m_workers[(index + i) % m_workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty())
+            {
+                Task task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return task;
+            }
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCv.wait(lock, [this]()
+                          { return m_queued > 0 || !m_running; });
+            if (!m_running)
+            {
+                return;
+            }
+            m_queued--;
+        }
+
+        Task task = take(index);
+        task();
+    }
+}
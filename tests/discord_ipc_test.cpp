@@ -0,0 +1,80 @@
+/**
+ * DiscordIPC: writes to a Discord that stops reading give up after the write timeout
+ * instead of blocking the writer (the shared timer thread, in the app) indefinitely
+ */
+
+// Standard library headers
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+// Platform-specific headers
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Project headers
+#include "discord_ipc.h"
+#include "logger.h"
+#include "test_support.h"
+
+namespace
+{
+    // WRITE_TIMEOUT_MS in discord_ipc.cpp, plus slack for a loaded machine
+    constexpr auto WRITE_TIMEOUT = std::chrono::seconds(5);
+    constexpr auto MAX_WRITE_STALL = WRITE_TIMEOUT + std::chrono::seconds(3);
+
+    void testWriteToStalledPeerTimesOut()
+    {
+        // Under /tmp: a socket path must fit in sun_path, which a build tree may not
+        char dirTemplate[] = "/tmp/discord_ipc_test.XXXXXX";
+        REQUIRE(mkdtemp(dirTemplate));
+        std::filesystem::path dir = dirTemplate;
+        // Where openPipe() looks on Linux and (with the trailing slash) on macOS
+        setenv("XDG_RUNTIME_DIR", dir.c_str(), 1);
+        setenv("TMPDIR", (dir.string() + "/").c_str(), 1);
+
+        std::string path = (dir / "discord-ipc-0").string();
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        REQUIRE(listener >= 0);
+        REQUIRE(bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0);
+        REQUIRE(listen(listener, 1) == 0);
+
+        DiscordIPC ipc;
+        REQUIRE(ipc.openPipe());
+        int peer = accept(listener, nullptr, nullptr);
+        REQUIRE(peer >= 0);
+
+        // The peer never reads: writes succeed until the socket buffer is full, then the
+        // next one must fail once the timeout has passed
+        std::string payload(64 * 1024, 'x');
+        bool failed = false;
+        auto blockedFor = std::chrono::steady_clock::duration::zero();
+        for (int i = 0; i < 1000 && !failed; i++)
+        {
+            auto started = std::chrono::steady_clock::now();
+            failed = !ipc.writeFrame(OP_FRAME, payload);
+            blockedFor = std::chrono::steady_clock::now() - started;
+        }
+        CHECK(failed);
+        CHECK(blockedFor >= WRITE_TIMEOUT - std::chrono::milliseconds(100));
+        CHECK(blockedFor < MAX_WRITE_STALL);
+        CHECK(!ipc.isConnected());
+
+        ipc.closePipe();
+        close(peer);
+        close(listener);
+        std::filesystem::remove_all(dir);
+    }
+}
+
+int main()
+{
+    Logger::getInstance().setLogLevel(LogLevel::Warning);
+    return test::runTests({{"write to a stalled peer times out", testWriteToStalledPeerTimesOut}});
+}
@@ -0,0 +1,250 @@
+/**
+ * getCurrentPlayback() must not wait for session enrichment: while updateSessionInfo()
+ * is blocked on a slow /library/metadata request, reading the current playback should
+ * stay sub-millisecond and keep returning the last committed session.
+ *
+ * A local server stands in for plex.tv and the Plex Media Server; the test feeds
+ * notifications through the real SSE path and holds the slow response until released.
+ */
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Project headers
+#include "config.h"
+#include "logger.h"
+#include "plex.h"
+#include "test_http_server.h"
+#include "test_support.h"
+
+namespace
+{
+    constexpr const char *FAST_KEY = "/library/metadata/1";
+    constexpr const char *SLOW_KEY = "/library/metadata/2";
+    constexpr const char *FAST_TITLE = "Fast Movie";
+    constexpr const char *SLOW_TITLE = "Slow Movie";
+
+    constexpr int LATENCY_SAMPLES = 2000;
+    constexpr auto SUB_MILLISECOND = std::chrono::microseconds(1000);
+    // No single read may wait for the held response; the slack only absorbs preemption
+    constexpr auto MAX_STALL = std::chrono::milliseconds(50);
+
+    /**
+     * @brief Plex endpoints backed by a notification queue and a gate on the slow item
+     */
+    class FakePlex
+    {
+    public:
+        FakePlex() : m_server([this](const TestHttpServer::Request &request, int fd)
+                              { return handle(request, fd); })
+        {
+        }
+
+        bool start()
+        {
+            return m_server.start();
+        }
+
+        void stop()
+        {
+            release();
+            m_server.stop();
+        }
+
+        std::string baseUrl() const
+        {
+            return m_server.baseUrl();
+        }
+
+        void notify(const std::string &sessionKey, const std::string &key, int64_t viewOffset)
+        {
+            nlohmann::json event = {{"PlaySessionStateNotification",
+                                     {{"sessionKey", sessionKey}, {"key", key}, {"state", "playing"}, {"viewOffset", viewOffset}}}};
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_events.push_back("event: playing\ndata: " + event.dump() + "\n\n");
+            m_cv.notify_all();
+        }
+
+        bool slowRequestStarted()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_slowStarted;
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_released = true;
+            m_cv.notify_all();
+        }
+
+    private:
+        static std::string movie(const std::string &title)
+        {
+            nlohmann::json item = {{"type", "movie"}, {"title", title}, {"year", 2000}, {"duration", 600000}};
+            return nlohmann::json({{"MediaContainer", {{"size", 1}, {"Metadata", {item}}}}}).dump();
+        }
+
+        bool handle(const TestHttpServer::Request &request, int fd)
+        {
+            if (request.path == "/api/v2/resources")
+            {
+                nlohmann::json resources = nlohmann::json::array(
+                    {{{"name", "Test Server"},
+                      {"provides", "server"},
+                      {"clientIdentifier", "test-server"},
+                      {"accessToken", "server-token"},
+                      {"owned", false},
+                      {"connections", {{{"uri", m_server.baseUrl()}, {"local", true}}}}}});
+                return TestHttpServer::respond(fd, 200, resources.dump());
+            }
+            if (request.path == "/identity")
+            {
+                return TestHttpServer::respond(fd, 200, R"({"MediaContainer":{"machineIdentifier":"test-server"}})");
+            }
+            if (request.path == "/:/eventsource/notifications")
+            {
+                streamEvents(fd);
+                return false;
+            }
+            if (request.path == FAST_KEY)
+            {
+                return TestHttpServer::respond(fd, 200, movie(FAST_TITLE));
+            }
+            if (request.path == SLOW_KEY)
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_slowStarted = true;
+                while (!m_released && !m_server.stopping())
+                {
+                    m_cv.wait_for(lock, std::chrono::milliseconds(20));
+                }
+                lock.unlock();
+                return TestHttpServer::respond(fd, 200, movie(SLOW_TITLE));
+            }
+            return TestHttpServer::respond(fd, 404, "{}");
+        }
+
+        void streamEvents(int fd)
+        {
+            if (!TestHttpServer::beginEventStream(fd))
+            {
+                return;
+            }
+            while (!m_server.stopping())
+            {
+                std::string event;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait_for(lock, std::chrono::milliseconds(20), [this]()
+                                  { return !m_events.empty(); });
+                    if (m_events.empty())
+                    {
+                        continue;
+                    }
+                    event = m_events.front();
+                    m_events.pop_front();
+                }
+                if (!TestHttpServer::sendAll(fd, event))
+                {
+                    return;
+                }
+            }
+        }
+
+        TestHttpServer m_server;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<std::string> m_events;
+        bool m_slowStarted = false;
+        bool m_released = false;
+    };
+
+    std::string currentTitle(Plex &plex)
+    {
+        MediaInfo info = plex.getCurrentPlayback();
+        return info.state == PlaybackState::Playing ? info.title : "";
+    }
+
+    void testPlaybackReadsDoNotWaitForEnrichment()
+    {
+        FakePlex fake;
+        REQUIRE(fake.start());
+        setenv("PRESENCE_PLEX_TV_URL", fake.baseUrl().c_str(), 1);
+
+        Plex plex;
+        REQUIRE(plex.init());
+
+        // A committed session to read while the next one is being enriched; it started a
+        // minute ago, so the newer session replaces it once committed
+        fake.notify("1", FAST_KEY, 60000);
+        REQUIRE(test::waitFor([&]()
+                              { return currentTitle(plex) == FAST_TITLE; },
+                              std::chrono::seconds(10)));
+
+        fake.notify("2", SLOW_KEY, 0);
+        REQUIRE(test::waitFor([&]()
+                              { return fake.slowRequestStarted(); },
+                              std::chrono::seconds(10)));
+
+        std::vector<std::chrono::nanoseconds> samples;
+        samples.reserve(LATENCY_SAMPLES);
+        bool sawCommittedSession = true;
+        for (int i = 0; i < LATENCY_SAMPLES; i++)
+        {
+            auto started = std::chrono::steady_clock::now();
+            MediaInfo info = plex.getCurrentPlayback();
+            samples.push_back(std::chrono::steady_clock::now() - started);
+            sawCommittedSession = sawCommittedSession && info.title == FAST_TITLE;
+        }
+        CHECK(fake.slowRequestStarted());
+        CHECK(sawCommittedSession);
+
+        std::sort(samples.begin(), samples.end());
+        auto median = samples[samples.size() / 2];
+        auto p99 = samples[samples.size() * 99 / 100];
+        std::cout << "getCurrentPlayback during slow enrichment: median "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(median).count() << " us, p99 "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(p99).count() << " us, max "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(samples.back()).count() << " us"
+                  << std::endl;
+        CHECK(p99 < SUB_MILLISECOND);
+        CHECK(samples.back() < MAX_STALL);
+
+        // Once the slow fetch completes, its session is committed and becomes current
+        fake.release();
+        CHECK(test::waitFor([&]()
+                            { return currentTitle(plex) == SLOW_TITLE; },
+                            std::chrono::seconds(10)));
+
+        plex.stop();
+        fake.stop();
+    }
+}
+
+int main()
+{
+    // A fresh config directory under the build tree keeps the user's real config, log and
+    // metadata caches out of the test
+    std::filesystem::path configRoot = std::filesystem::current_path() / "plex_session_lock_test.config";
+    std::filesystem::remove_all(configRoot);
+    std::filesystem::create_directories(configRoot);
+    setenv("XDG_CONFIG_DIR", configRoot.c_str(), 1);
+
+    Logger::getInstance().setLogLevel(LogLevel::Warning);
+    auto &config = Config::getInstance();
+    config.setPlexAuthToken("test-token");
+    config.setPlexClientIdentifier("test-client");
+    config.setPersistentCacheEnabled(false);
+
+    return test::runTests({{"playback reads do not wait for enrichment", testPlaybackReadsDoNotWaitForEnrichment}});
+}
@@ -0,0 +1,266 @@
+/**
+ * Scheduler: idle wakeups, timers cascading down the wheel levels, and schedule/cancel
+ * racing tasks that are already running on the timer thread
+ */
+
+// Standard library headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Project headers
+#include "logger.h"
+#include "scheduler.h"
+#include "test_support.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto IDLE_INTERVAL = std::chrono::seconds(3);
+    // A timer fires on the first 10 ms tick at or after its deadline; the rest is slack
+    // for a loaded machine
+    constexpr auto MAX_LATENESS = std::chrono::milliseconds(60);
+
+    uint64_t wakeups()
+    {
+        return Scheduler::getInstance().stats().wakeups;
+    }
+
+    struct Firing
+    {
+        Clock::time_point deadline;
+        std::atomic<int64_t> firedAtNs{0};
+    };
+
+    /**
+     * @brief Schedules a timer that records when it fired
+     */
+    std::shared_ptr<Firing> scheduleRecorded(std::chrono::milliseconds delay)
+    {
+        auto firing = std::make_shared<Firing>();
+        firing->deadline = Clock::now() + delay;
+        Scheduler::getInstance().schedule(delay, [firing]()
+                                          { firing->firedAtNs = Clock::now().time_since_epoch().count(); });
+        return firing;
+    }
+
+    void checkFiredOnTime(const Firing &firing)
+    {
+        int64_t firedAtNs = firing.firedAtNs;
+        REQUIRE(firedAtNs != 0);
+        Clock::time_point firedAt{Clock::duration(firedAtNs)};
+        CHECK(firedAt >= firing.deadline);
+        CHECK(firedAt - firing.deadline < MAX_LATENESS);
+    }
+
+    void testIdleWakeups()
+    {
+        auto &scheduler = Scheduler::getInstance();
+
+        // Start the timer thread and let it settle with nothing pending
+        std::atomic<bool> ran{false};
+        scheduler.schedule(std::chrono::milliseconds(10), [&ran]()
+                           { ran = true; });
+        REQUIRE(test::waitFor([&ran]()
+                              { return ran.load(); },
+                              std::chrono::seconds(5)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(scheduler.stats().pending == 0);
+
+        uint64_t before = wakeups();
+        std::this_thread::sleep_for(IDLE_INTERVAL);
+        uint64_t idle = wakeups() - before;
+        std::cout << "wakeups with no timers: " << idle << " in " << IDLE_INTERVAL.count() << " s" << std::endl;
+        CHECK(idle == 0);
+
+        // A distant timer sleeps in an upper level until its slot cascades, minutes away
+        Scheduler::TaskId distant = scheduler.schedule(std::chrono::minutes(5), []() {});
+        before = wakeups();
+        std::this_thread::sleep_for(IDLE_INTERVAL);
+        uint64_t pending = wakeups() - before;
+        std::cout << "wakeups with a 5 min timer pending: " << pending << " in " << IDLE_INTERVAL.count() << " s" << std::endl;
+        CHECK(pending < static_cast<uint64_t>(IDLE_INTERVAL.count()));
+        CHECK(scheduler.cancel(distant));
+    }
+
+    void testCascadeAcrossLevelOne()
+    {
+        // Level 0 covers 64 ticks (640 ms); staggered delays around and past that edge
+        // land at every offset relative to the level 1 slot boundaries
+        std::vector<std::shared_ptr<Firing>> firings;
+        for (int delay = 5; delay <= 2600; delay += 37)
+        {
+            firings.push_back(scheduleRecorded(std::chrono::milliseconds(delay)));
+        }
+        for (int delay : {630, 639, 640, 641, 650, 1279, 1280, 1281})
+        {
+            firings.push_back(scheduleRecorded(std::chrono::milliseconds(delay)));
+        }
+
+        REQUIRE(test::waitFor([&firings]()
+                              {
+            for (const auto &firing : firings)
+            {
+                if (firing->firedAtNs == 0)
+                {
+                    return false;
+                }
+            }
+            return true; },
+                              std::chrono::seconds(10)));
+        for (const auto &firing : firings)
+        {
+            checkFiredOnTime(*firing);
+        }
+    }
+
+    void testCascadeAcrossLevelTwo()
+    {
+        // Level 1 covers 4096 ticks (40.96 s), so this timer starts in level 2 and has to
+        // cascade through level 1 and level 0 before it fires, waking only for those steps
+        constexpr auto delay = std::chrono::milliseconds(41500);
+        uint64_t before = wakeups();
+        auto firing = scheduleRecorded(delay);
+        REQUIRE(test::waitFor([&firing]()
+                              { return firing->firedAtNs != 0; },
+                              delay + std::chrono::seconds(5)));
+        checkFiredOnTime(*firing);
+
+        uint64_t woken = wakeups() - before;
+        std::cout << "wakeups for a " << delay.count() << " ms timer: " << woken << std::endl;
+        CHECK(woken <= 6);
+    }
+
+    void testCancelWaitsForRunningTask()
+    {
+        auto &scheduler = Scheduler::getInstance();
+        std::atomic<bool> started{false};
+        std::atomic<bool> finished{false};
+        Scheduler::TaskId id = scheduler.schedule(std::chrono::milliseconds(0), [&]()
+                                                  {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            finished = true; });
+        REQUIRE(test::waitFor([&started]()
+                              { return started.load(); },
+                              std::chrono::seconds(5)));
+
+        // Too late to cancel, but the call must not return while the task still runs
+        CHECK(!scheduler.cancel(id));
+        CHECK(finished);
+    }
+
+    void testTaskCancelsAndReschedulesItself()
+    {
+        auto &scheduler = Scheduler::getInstance();
+        std::atomic<Scheduler::TaskId> selfId{0};
+        std::atomic<bool> selfCancelResult{true};
+        std::atomic<int> runs{0};
+
+        std::mutex idMutex;
+        std::unique_lock<std::mutex> holdId(idMutex);
+        Scheduler::TaskId id = scheduler.schedule(std::chrono::milliseconds(10), [&]()
+                                                  {
+            {
+                std::lock_guard<std::mutex> lock(idMutex);
+            }
+            // Cancelling itself must not deadlock on its own completion
+            selfCancelResult = scheduler.cancel(selfId);
+            runs++;
+            scheduler.schedule(std::chrono::milliseconds(10), [&runs]()
+                               { runs++; }); });
+        selfId = id;
+        holdId.unlock();
+
+        CHECK(test::waitFor([&runs]()
+                            { return runs == 2; },
+                            std::chrono::seconds(5)));
+        CHECK(!selfCancelResult);
+    }
+
+    void testScheduleCancelRace()
+    {
+        // Producers schedule short timers and cancel them while the timer thread is busy
+        // running others: every timer must either run once or be cancelled, never both
+        constexpr int THREADS = 4;
+        constexpr int PER_THREAD = 2000;
+
+        struct Entry
+        {
+            std::atomic<int> runs{0};
+            std::atomic<bool> cancelled{false};
+            std::atomic<bool> ranAfterCancel{false};
+        };
+        std::vector<Entry> entries(THREADS * PER_THREAD);
+
+        auto &scheduler = Scheduler::getInstance();
+        std::vector<std::thread> producers;
+        for (int t = 0; t < THREADS; t++)
+        {
+            producers.emplace_back([&, t]()
+                                   {
+                for (int i = 0; i < PER_THREAD; i++)
+                {
+                    Entry &entry = entries[t * PER_THREAD + i];
+                    Scheduler::TaskId id = scheduler.schedule(std::chrono::milliseconds(i % 3 * 10), [&entry]()
+                                                              {
+                        if (entry.cancelled)
+                        {
+                            entry.ranAfterCancel = true;
+                        }
+                        entry.runs++; });
+                    if (i % 2 == 0)
+                    {
+                        if (i % 4 == 0)
+                        {
+                            std::this_thread::sleep_for(std::chrono::microseconds(50));
+                        }
+                        entry.cancelled = scheduler.cancel(id);
+                    }
+                } });
+        }
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+
+        REQUIRE(test::waitFor([&scheduler]()
+                              { return scheduler.stats().pending == 0; },
+                              std::chrono::seconds(10)));
+        // Let the last task that was taken off the wheel finish
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        int cancelled = 0;
+        bool exactlyOnce = true;
+        bool ranAfterCancel = false;
+        for (const auto &entry : entries)
+        {
+            cancelled += entry.cancelled ? 1 : 0;
+            exactlyOnce = exactlyOnce && entry.runs == (entry.cancelled ? 0 : 1);
+            ranAfterCancel = ranAfterCancel || entry.ranAfterCancel;
+        }
+        std::cout << "cancelled " << cancelled << " of " << entries.size() << " timers" << std::endl;
+        CHECK(exactlyOnce);
+        CHECK(!ranAfterCancel);
+        CHECK(cancelled > 0);
+    }
+}
+
+int main()
+{
+    Logger::getInstance().setLogLevel(LogLevel::Warning);
+
+    int result = test::runTests({{"idle wakeups", testIdleWakeups},
+                                 {"cascade across level 1", testCascadeAcrossLevelOne},
+                                 {"cancel waits for a running task", testCancelWaitsForRunningTask},
+                                 {"task cancels and reschedules itself", testTaskCancelsAndReschedulesItself},
+                                 {"schedule/cancel race", testScheduleCancelRace},
+                                 {"cascade across level 2", testCascadeAcrossLevelTwo}});
+    Scheduler::getInstance().shutdown();
+    return result;
+}
@@ -0,0 +1,98 @@
+/**
+ * SlidingWindowLimiter: greedy senders paced by the Discord frame limits never exceed
+ * them in any window, and still get the full rate the limits allow
+ */
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// Project headers
+#include "sliding_window_limiter.h"
+#include "test_support.h"
+
+namespace
+{
+    using Clock = SlidingWindowLimiter::Clock;
+    using std::chrono::milliseconds;
+
+    size_t maxInAnyWindow(const std::vector<Clock::time_point> &sends, Clock::duration window)
+    {
+        size_t most = 0;
+        for (size_t i = 0; i < sends.size(); i++)
+        {
+            // Windows are half-open, [start, start + window)
+            size_t count = std::lower_bound(sends.begin() + i, sends.end(), sends[i] + window) - (sends.begin() + i);
+            most = (std::max)(most, count);
+        }
+        return most;
+    }
+
+    void testSingleWindow()
+    {
+        SlidingWindowLimiter limiter(2, milliseconds(5000));
+        Clock::time_point t0 = Clock::now();
+
+        CHECK(limiter.timeUntilAvailable(t0) == Clock::duration::zero());
+        limiter.record(t0);
+        CHECK(limiter.timeUntilAvailable(t0) == Clock::duration::zero());
+        limiter.record(t0 + milliseconds(1000));
+
+        // The next event waits exactly until the oldest one leaves the window
+        CHECK(limiter.timeUntilAvailable(t0 + milliseconds(1000)) == milliseconds(4000));
+        CHECK(limiter.timeUntilAvailable(t0 + milliseconds(4999)) == milliseconds(1));
+        CHECK(limiter.timeUntilAvailable(t0 + milliseconds(5000)) == Clock::duration::zero());
+        limiter.record(t0 + milliseconds(5000));
+        CHECK(limiter.timeUntilAvailable(t0 + milliseconds(5000)) == milliseconds(1000));
+
+        limiter.reset();
+        CHECK(limiter.timeUntilAvailable(t0 + milliseconds(5000)) == Clock::duration::zero());
+    }
+
+    void testGreedyDiscordPacing()
+    {
+        // The limits Discord::frameDelay applies: 1 s apart, 2 per 5 s, 4 per 15 s
+        SlidingWindowLimiter shortWindow(2, milliseconds(5000));
+        SlidingWindowLimiter longWindow(4, milliseconds(15000));
+        const Clock::duration minInterval = milliseconds(1000);
+
+        Clock::time_point t0 = Clock::now();
+        Clock::time_point now = t0;
+        std::vector<Clock::time_point> sends;
+        while (now < t0 + std::chrono::seconds(120))
+        {
+            Clock::duration delay = Clock::duration::zero();
+            if (!sends.empty())
+            {
+                delay = (std::max)(delay, sends.back() + minInterval - now);
+            }
+            delay = (std::max)(delay, shortWindow.timeUntilAvailable(now));
+            delay = (std::max)(delay, longWindow.timeUntilAvailable(now));
+            if (delay > Clock::duration::zero())
+            {
+                now += delay;
+                continue;
+            }
+
+            shortWindow.record(now);
+            longWindow.record(now);
+            sends.push_back(now);
+        }
+
+        CHECK(maxInAnyWindow(sends, milliseconds(15000)) == 4);
+        CHECK(maxInAnyWindow(sends, milliseconds(5000)) == 2);
+        // Sustained, the long window is the bound: 4 frames per 15 s over 120 s
+        CHECK(sends.size() == 32);
+        for (size_t i = 1; i < sends.size(); i++)
+        {
+            CHECK(sends[i] - sends[i - 1] >= minInterval);
+        }
+    }
+}
+
+int main()
+{
+    return test::runTests({{"single window", testSingleWindow},
+                           {"greedy Discord pacing", testGreedyDiscordPacing}});
+}
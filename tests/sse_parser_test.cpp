@@ -0,0 +1,124 @@
+/**
+ * SSEParser: event framing across chunk boundaries and last-event-ID bookkeeping
+ */
+
+// Standard library headers
+#include <string>
+#include <vector>
+
+// Project headers
+#include "sse_parser.h"
+#include "test_support.h"
+
+namespace
+{
+    struct Received
+    {
+        std::string type;
+        std::string data;
+        std::string id;
+    };
+
+    class Collector
+    {
+    public:
+        Collector() : parser([this](const SSEEvent &event)
+                             { events.push_back({std::string(event.type), std::string(event.data), std::string(event.id)}); })
+        {
+        }
+
+        void feed(const std::string &text)
+        {
+            parser.feed(text.data(), text.size());
+        }
+
+        SSEParser parser;
+        std::vector<Received> events;
+    };
+
+    void testMultiLineDataAndFields()
+    {
+        Collector c;
+        c.feed("event: playing\r\ndata: {\"a\":1}\r\ndata: second\r\n: comment\r\nid: 7\r\nretry: 1500\r\n\r\n");
+        REQUIRE(c.events.size() == 1);
+        CHECK(c.events[0].type == "playing");
+        CHECK(c.events[0].data == "{\"a\":1}\nsecond");
+        CHECK(c.events[0].id == "7");
+        CHECK(c.parser.lastEventId() == "7");
+        CHECK(c.parser.retryMs() == 1500);
+    }
+
+    void testEventsSplitAcrossChunks()
+    {
+        const std::string stream = "data: one\r\n\r\ndata: two\n\ndata: three\r\r";
+        for (size_t split = 1; split < stream.size(); split++)
+        {
+            Collector c;
+            c.feed(stream.substr(0, split));
+            c.feed(stream.substr(split));
+            REQUIRE(c.events.size() == 3);
+            CHECK(c.events[0].data == "one");
+            CHECK(c.events[1].data == "two");
+            CHECK(c.events[2].data == "three");
+            CHECK(c.events[0].type == "message");
+        }
+    }
+
+    void testIdCommittedOnlyOnDispatch()
+    {
+        Collector c;
+        c.feed("id: 1\ndata: first\n\n");
+        CHECK(c.parser.lastEventId() == "1");
+
+        // The stream drops after the id: line of the next event
+        c.feed("id: 2\ndata: second\n");
+        CHECK(c.parser.lastEventId() == "1");
+
+        // Reconnecting drops the partial event and its ID; replayed events set it again
+        c.parser.reset();
+        CHECK(c.parser.lastEventId() == "1");
+        c.feed("data: unnamed\n\n");
+        REQUIRE(c.events.size() == 2);
+        CHECK(c.events[1].id == "1");
+        CHECK(c.parser.lastEventId() == "1");
+
+        c.feed("id: 2\ndata: second\n\n");
+        REQUIRE(c.events.size() == 3);
+        CHECK(c.events[2].id == "2");
+        CHECK(c.parser.lastEventId() == "2");
+    }
+
+    void testIdWithoutDataIsCommitted()
+    {
+        Collector c;
+        c.feed("id: 5\n\n");
+        CHECK(c.events.empty());
+        CHECK(c.parser.lastEventId() == "5");
+
+        // An empty id: clears the last event ID
+        c.feed("id\ndata: x\n\n");
+        REQUIRE(c.events.size() == 1);
+        CHECK(c.events[0].id.empty());
+        CHECK(c.parser.lastEventId().empty());
+    }
+
+    void testOversizedEventIsDropped()
+    {
+        Collector c;
+        c.feed("id: big\ndata: ");
+        c.feed(std::string(2 * 1024 * 1024, 'x'));
+        c.feed("\n\nid: 9\ndata: after\n\n");
+        REQUIRE(c.events.size() == 1);
+        CHECK(c.events[0].data == "after");
+        CHECK(c.parser.lastEventId() == "9");
+    }
+}
+
+int main()
+{
+    return test::runTests({{"multi-line data and fields", testMultiLineDataAndFields},
+                           {"events split across chunks", testEventsSplitAcrossChunks},
+                           {"id committed only on dispatch", testIdCommittedOnlyOnDispatch},
+                           {"id without data is committed", testIdWithoutDataIsCommitted},
+                           {"oversized event is dropped", testOversizedEventIsDropped}});
+}
@@ -0,0 +1,276 @@
+#pragma once
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Platform-specific headers
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief In-process HTTP/1.1 server for tests (POSIX only)
+ *
+ * Listens on an ephemeral loopback port and runs a handler per request on a thread per
+ * connection. Handlers may block (to emulate a slow endpoint) or keep writing to the
+ * socket (an SSE stream); they should return once stopping() is true.
+ */
+class TestHttpServer
+{
+public:
+    struct Request
+    {
+        std::string method;
+        std::string path;
+        std::string query;
+        std::map<std::string, std::string> headers; // Lower-case names
+    };
+
+    // Returns whether the connection may serve another request
+    using Handler = std::function<bool(const Request &request, int fd)>;
+
+    explicit TestHttpServer(Handler handler) : m_handler(std::move(handler))
+    {
+    }
+
+    ~TestHttpServer()
+    {
+        stop();
+    }
+
+    bool start()
+    {
+        m_listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_listener < 0)
+        {
+            return false;
+        }
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t addrLen = sizeof(addr);
+        if (bind(m_listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            listen(m_listener, 16) != 0 ||
+            getsockname(m_listener, reinterpret_cast<sockaddr *>(&addr), &addrLen) != 0)
+        {
+            close(m_listener);
+            m_listener = -1;
+            return false;
+        }
+        m_port = ntohs(addr.sin_port);
+
+        m_acceptThread = std::thread(&TestHttpServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop()
+    {
+        if (m_stopping.exchange(true))
+        {
+            return;
+        }
+        if (m_acceptThread.joinable())
+        {
+            m_acceptThread.join();
+        }
+        if (m_listener >= 0)
+        {
+            close(m_listener);
+        }
+
+        {
+            // Unblock handlers waiting on their client
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int fd : m_clients)
+            {
+                shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (auto &thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    bool stopping() const
+    {
+        return m_stopping;
+    }
+
+    std::string baseUrl() const
+    {
+        return "http://127.0.0.1:" + std::to_string(m_port);
+    }
+
+    size_t connectionCount() const
+    {
+        return m_connections;
+    }
+
+    static bool sendAll(int fd, const std::string &data)
+    {
+        size_t total = 0;
+        while (total < data.size())
+        {
+            ssize_t n = send(fd, data.data() + total, data.size() - total, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            total += n;
+        }
+        return true;
+    }
+
+    static bool respond(int fd, int status, const std::string &body,
+                        const std::string &contentType = "application/json")
+    {
+        std::ostringstream response;
+        response << "HTTP/1.1 " << status << (status < 400 ? " OK" : " Error") << "\r\n"
+                 << "Content-Type: " << contentType << "\r\n"
+                 << "Content-Length: " << body.size() << "\r\n\r\n"
+                 << body;
+        return sendAll(fd, response.str());
+    }
+
+    // Starts an event stream; follow with sendAll() of "data: ...\n\n" blocks
+    static bool beginEventStream(int fd)
+    {
+        return sendAll(fd, "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nConnection: close\r\n\r\n");
+    }
+
+private:
+    void acceptLoop()
+    {
+        while (!m_stopping)
+        {
+            struct pollfd pfd = {m_listener, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0)
+            {
+                continue;
+            }
+            int fd = accept(m_listener, nullptr, nullptr);
+            if (fd < 0)
+            {
+                continue;
+            }
+
+            m_connections++;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_clients.push_back(fd);
+            m_threads.emplace_back(&TestHttpServer::serve, this, fd);
+        }
+    }
+
+    void serve(int fd)
+    {
+        std::string buffer;
+        Request request;
+        while (!m_stopping && readRequest(fd, buffer, request) && m_handler(request, fd))
+        {
+            request = Request();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), fd), m_clients.end());
+        close(fd);
+    }
+
+    bool readRequest(int fd, std::string &buffer, Request &request)
+    {
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+        {
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            buffer.append(chunk, n);
+        }
+
+        std::istringstream head(buffer.substr(0, headerEnd));
+        buffer.erase(0, headerEnd + 4);
+
+        std::string line;
+        std::string target;
+        std::getline(head, line);
+        std::istringstream requestLine(line);
+        if (!(requestLine >> request.method >> target))
+        {
+            return false;
+        }
+        size_t queryStart = target.find('?');
+        request.path = target.substr(0, queryStart);
+        request.query = queryStart == std::string::npos ? "" : target.substr(queryStart + 1);
+
+        size_t contentLength = 0;
+        while (std::getline(head, line))
+        {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos)
+            {
+                continue;
+            }
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            std::string value = line.substr(colon + 1);
+            value.erase(0, value.find_first_not_of(' '));
+            value.erase(value.find_last_not_of("\r ") + 1);
+            request.headers[name] = value;
+            if (name == "content-length")
+            {
+                contentLength = std::stoul(value);
+            }
+        }
+
+        // Request bodies are not needed by any test; skip them
+        while (buffer.size() < contentLength)
+        {
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+            {
+                return false;
+            }
+            buffer.append(chunk, n);
+        }
+        buffer.erase(0, contentLength);
+        return true;
+    }
+
+    Handler m_handler;
+    int m_listener = -1;
+    int m_port = 0;
+    std::atomic<bool> m_stopping{false};
+    std::atomic<size_t> m_connections{0};
+    std::thread m_acceptThread;
+
+    std::mutex m_mutex;
+    std::vector<int> m_clients;
+    std::vector<std::thread> m_threads;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+// Standard library headers
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+/**
+ * Minimal test harness: each test binary lists its cases in main() and returns
+ * runTests(), which is non-zero if any CHECK failed. ctest runs the binaries.
+ */
+namespace test
+{
+    inline int &failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    using Case = std::pair<const char *, std::function<void()>>;
+
+    inline int runTests(std::initializer_list<Case> cases)
+    {
+        for (const auto &testCase : cases)
+        {
+            int before = failures();
+            std::cout << "[ RUN  ] " << testCase.first << std::endl;
+            testCase.second();
+            std::cout << (failures() == before ? "[  OK  ] " : "[ FAIL ] ") << testCase.first << std::endl;
+        }
+        return failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /**
+     * @brief Polls a condition until it holds or the timeout passes
+     * @return The last value of the condition
+     */
+    inline bool waitFor(const std::function<bool()> &condition, std::chrono::milliseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!condition())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+}
+
+#define CHECK(condition)                                                                \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(condition))                                                               \
+        {                                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" \
+                      << std::endl;                                                     \
+            test::failures()++;                                                         \
+        }                                                                               \
+    } while (0)
+
+// Like CHECK, but ends the current test case on failure
+#define REQUIRE(condition)                      \
+    do                                          \
+    {                                           \
+        int failuresBefore = test::failures();  \
+        CHECK(condition);                       \
+        if (test::failures() != failuresBefore) \
+        {                                       \
+            return;                             \
+        }                                       \
+    } while (0)
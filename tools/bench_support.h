@@ -0,0 +1,110 @@
+#pragma once
+
+/**
+ * Timing and allocation counting for the microbenchmarks in tools/
+ *
+ * Replaces the global operator new/delete to count heap allocations, so include it
+ * from exactly one translation unit per benchmark executable.
+ */
+
+// Standard library headers
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace bench
+{
+    inline std::atomic<uint64_t> &allocationCount()
+    {
+        static std::atomic<uint64_t> count{0};
+        return count;
+    }
+
+    inline std::atomic<uint64_t> &allocatedBytes()
+    {
+        static std::atomic<uint64_t> bytes{0};
+        return bytes;
+    }
+
+    struct Result
+    {
+        double nsPerOp = 0;
+        double allocationsPerOp = 0;
+        double bytesPerOp = 0;
+        double opsPerSecond = 0;
+    };
+
+    /**
+     * @brief Runs body iterations times after a short warm-up and averages the cost
+     */
+    template <typename Body>
+    Result measure(size_t iterations, Body &&body)
+    {
+        for (size_t i = 0; i < iterations / 10 + 1; i++)
+        {
+            body();
+        }
+
+        uint64_t allocationsBefore = allocationCount();
+        uint64_t bytesBefore = allocatedBytes();
+        auto started = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            body();
+        }
+        double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - started).count();
+
+        Result result;
+        result.nsPerOp = elapsedNs / iterations;
+        result.allocationsPerOp = static_cast<double>(allocationCount() - allocationsBefore) / iterations;
+        result.bytesPerOp = static_cast<double>(allocatedBytes() - bytesBefore) / iterations;
+        result.opsPerSecond = 1e9 / result.nsPerOp;
+        return result;
+    }
+
+    inline void report(const char *name, const Result &result)
+    {
+        std::printf("%-36s %12.0f ns/op %12.0f ops/s %10.2f allocs/op %12.0f bytes/op\n", name,
+                    result.nsPerOp, result.opsPerSecond, result.allocationsPerOp, result.bytesPerOp);
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    bench::allocationCount()++;
+    bench::allocatedBytes() += size;
+    if (void *memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+#
+# End-to-end check of the Discord frame pacing (Linux)
+#
+# Runs PresenceForPlex against mock_plex, which switches the playing item every second,
+# and mock_discord, which fails unless the app sent enough SET_ACTIVITY frames to hit
+# the limits and never more than 2 in 5 s or 4 in 15 s.
+#
+# Usage:
+#   check_pacing.sh APP MOCK_PLEX MOCK_DISCORD [SECONDS]
+
+set -u
+
+if [ $# -lt 3 ]; then
+    echo "Usage: $0 APP MOCK_PLEX MOCK_DISCORD [SECONDS]" >&2
+    exit 2
+fi
+
+APP=$1
+MOCK_PLEX=$2
+MOCK_DISCORD=$3
+DURATION=${4:-40}
+
+WORK=$(mktemp -d)
+trap 'kill $PLEX_PID $DISCORD_PID 2>/dev/null; rm -rf "$WORK"' EXIT
+mkdir -p "$WORK/home" "$WORK/ipc"
+
+"$MOCK_DISCORD" --dir "$WORK/ipc" --duration "$DURATION" --record "$WORK/discord.jsonl" \
+    --max-in-5s 2 --max-in-15s 4 --min-frames 6 2>"$WORK/discord.err" &
+DISCORD_PID=$!
+"$MOCK_PLEX" --port 0 --event-interval 500 --events-per-item 2 --duration "$DURATION" \
+    --record "$WORK/plex.jsonl" 2>"$WORK/plex.err" &
+PLEX_PID=$!
+
+# mock_plex prints its base URL once it listens
+BASE_URL=
+for _ in $(seq 50); do
+    BASE_URL=$(grep -o 'http://[0-9.:]*' "$WORK/plex.err" | head -n 1)
+    [ -n "$BASE_URL" ] && break
+    sleep 0.1
+done
+if [ -z "$BASE_URL" ]; then
+    echo "mock_plex did not start:" >&2
+    cat "$WORK/plex.err" >&2
+    exit 1
+fi
+
+HOME="$WORK/home" XDG_CONFIG_DIR="$WORK/home/.config" XDG_RUNTIME_DIR="$WORK/ipc" \
+    PRESENCE_PLEX_TV_URL="$BASE_URL" PRESENCE_TMDB_API_URL="$BASE_URL" PRESENCE_JIKAN_API_URL="$BASE_URL" \
+    timeout "$((DURATION - 2))" "$APP" >"$WORK/app.out" 2>&1
+
+wait "$DISCORD_PID"
+STATUS=$?
+wait "$PLEX_PID"
+
+cat "$WORK/discord.err"
+if [ "$STATUS" -ne 0 ]; then
+    echo "--- app output (last 40 lines) ---"
+    tail -n 40 "$WORK/app.out"
+fi
+exit "$STATUS"
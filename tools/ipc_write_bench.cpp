@@ -0,0 +1,227 @@
+/**
+ * Benchmark of DiscordIPC::writeFrame against the copy-then-write code it replaced
+ *
+ * Stands in for Discord with a Unix socket listener at $XDG_RUNTIME_DIR/discord-ipc-0
+ * (in a fresh temporary directory), connects the real DiscordIPC to it and writes
+ * SET_ACTIVITY-sized frames while a thread drains the other end. The old writer is
+ * reimplemented on a second connection to the same listener: it built both debug log
+ * strings whether or not they were logged, copied the frame into a fresh vector and
+ * wrote that. Reports frames per second and heap allocations per frame.
+ *
+ * Usage:
+ *   ipc_write_bench [--frames N] [--payload BYTES]
+ */
+
+// Standard library headers
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Platform-specific headers
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Project headers
+#include "bench_support.h"
+#include "discord_ipc.h"
+#include "logger.h"
+
+namespace
+{
+    /**
+     * @brief Reads and discards everything sent on a connection until it closes
+     */
+    class Drain
+    {
+    public:
+        explicit Drain(int fd) : m_fd(fd), m_thread([this]()
+                                                    { run(); })
+        {
+        }
+
+        ~Drain()
+        {
+            shutdown(m_fd, SHUT_RDWR);
+            m_thread.join();
+            close(m_fd);
+        }
+
+        uint64_t bytes() const
+        {
+            return m_bytes;
+        }
+
+    private:
+        void run()
+        {
+            std::vector<char> buffer(256 * 1024);
+            while (true)
+            {
+                ssize_t n = recv(m_fd, buffer.data(), buffer.size(), 0);
+                if (n <= 0 && !(n < 0 && errno == EINTR))
+                {
+                    return;
+                }
+                if (n > 0)
+                {
+                    m_bytes += static_cast<uint64_t>(n);
+                }
+            }
+        }
+
+        int m_fd;
+        std::atomic<uint64_t> m_bytes{0};
+        std::thread m_thread;
+    };
+
+    int connectTo(const std::string &path)
+    {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            return -1;
+        }
+        return fd;
+    }
+
+    // The writeFrame body before scatter-gather writes, minus the write mutex
+    bool copyingWriteFrame(int fd, int opcode, const std::string &payload)
+    {
+        // LOG_DEBUG built its message even when debug logging was off
+        std::string header = "Writing frame - Opcode: " + std::to_string(opcode) + ", Data length: " + std::to_string(payload.size());
+        std::string dump = "Writing frame data: " + payload;
+
+        uint32_t len = static_cast<uint32_t>(payload.size());
+        std::vector<char> buf(8 + len);
+        uint32_t fields[2] = {htole32(static_cast<uint32_t>(opcode)), htole32(len)};
+        memcpy(buf.data(), fields, sizeof(fields));
+        memcpy(buf.data() + 8, payload.data(), len);
+
+        size_t written = 0;
+        while (written < buf.size())
+        {
+            ssize_t n = send(fd, buf.data() + written, buf.size() - written, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            written += static_cast<size_t>(n);
+        }
+
+        std::string success = "Successfully wrote " + std::to_string(buf.size()) + " bytes";
+        return true;
+    }
+
+    std::string activityPayload(size_t size)
+    {
+        std::string payload = R"({"cmd":"SET_ACTIVITY","args":{"pid":12345,"activity":{"type":3,"details":"Some Show",)"
+                              R"("state":"S1 • E1 - Pilot","assets":{"large_image":"https://image.tmdb.org/t/p/w500/poster.jpg",)"
+                              R"("large_text":"Some Show"},"timestamps":{"start":1700000000,"end":1700002640}}},"nonce":"1",)"
+                              R"("padding":")";
+        if (payload.size() + 3 < size)
+        {
+            payload.append(size - payload.size() - 3, 'x');
+        }
+        return payload + "\"}}";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t frames = 200000;
+    size_t payloadSize = 600;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--frames")
+            frames = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (arg == "--payload")
+            payloadSize = std::strtoul(argv[i + 1], nullptr, 10);
+    }
+    if (argc % 2 == 0 || frames == 0)
+    {
+        std::cerr << "Usage: ipc_write_bench [--frames N] [--payload BYTES]\n";
+        return 2;
+    }
+
+    Logger::getInstance().setLogLevel(LogLevel::Warning);
+
+    char dirTemplate[] = "/tmp/ipc_write_bench.XXXXXX";
+    if (!mkdtemp(dirTemplate))
+    {
+        std::cerr << "mkdtemp failed: " << strerror(errno) << "\n";
+        return 1;
+    }
+    std::string dir = dirTemplate;
+    std::string socketPath = dir + "/discord-ipc-0";
+    setenv("XDG_RUNTIME_DIR", dir.c_str(), 1);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(listener, 4) != 0)
+    {
+        std::cerr << "Cannot listen on " << socketPath << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+
+    int result = 0;
+    {
+        std::string payload = activityPayload(payloadSize);
+        std::cout << frames << " frames of " << payload.size() << " bytes\n\n";
+
+        DiscordIPC ipc;
+        if (!ipc.openPipe())
+        {
+            std::cerr << "DiscordIPC could not connect to " << socketPath << "\n";
+            result = 1;
+        }
+        else
+        {
+            Drain ipcDrain(accept(listener, nullptr, nullptr));
+            int legacyFd = connectTo(socketPath);
+            Drain legacyDrain(accept(listener, nullptr, nullptr));
+
+            bool ok = true;
+            bench::Result legacy = bench::measure(frames, [&]()
+                                                  { ok = copyingWriteFrame(legacyFd, OP_FRAME, payload) && ok; });
+            bench::Result current = bench::measure(frames, [&]()
+                                                   { ok = ipc.writeFrame(OP_FRAME, payload) && ok; });
+            bench::report("copy + write (per frame)", legacy);
+            bench::report("DiscordIPC::writeFrame (per frame)", current);
+            if (!ok)
+            {
+                std::cerr << "A write failed\n";
+                result = 1;
+            }
+
+            ipc.closePipe();
+            close(legacyFd);
+        }
+    }
+
+    close(listener);
+    unlink(socketPath.c_str());
+    rmdir(dir.c_str());
+    return result;
+}
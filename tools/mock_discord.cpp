@@ -0,0 +1,520 @@
+/**
+ * Mock Discord IPC server for integration and load testing
+ *
+ * Listens on <dir>/discord-ipc-0 and speaks enough of Discord's IPC protocol for
+ * PresenceForPlex: the handshake is answered with READY, command frames with a reply
+ * echoing their nonce, PINGs with PONGs. Latency, ERROR replies and disconnects can be
+ * injected, every frame is recorded as a JSON line with a timestamp, and a summary of
+ * SET_ACTIVITY pacing (the rate limiter's output) is printed on exit.
+ *
+ * Usage:
+ *   mock_discord [--dir DIR] [--latency MS] [--error-every N] [--close-after N]
+ *                [--drop-after N] [--duration SECONDS] [--record FILE]
+ *                [--max-in-5s N] [--max-in-15s N] [--min-frames N]
+ *
+ * The last three turn the pacing summary into a check: the exit status is 1 if more
+ * SET_ACTIVITY frames arrived in some 5 s or 15 s window than allowed, or fewer than
+ * --min-frames arrived overall (so the limits were never actually exercised).
+ *
+ * Point the client at it with XDG_RUNTIME_DIR=DIR (TMPDIR=DIR/ on macOS). Without
+ * --dir a temporary directory is created and printed.
+ */
+
+// Standard library headers
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Platform-specific headers
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Third-party headers
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace
+{
+    constexpr uint32_t OP_HANDSHAKE = 0;
+    constexpr uint32_t OP_FRAME = 1;
+    constexpr uint32_t OP_CLOSE = 2;
+    constexpr uint32_t OP_PING = 3;
+    constexpr uint32_t OP_PONG = 4;
+
+    constexpr uint32_t MAX_FRAME_SIZE = 1024 * 1024;
+    constexpr int POLL_INTERVAL_MS = 100;
+
+    volatile std::sig_atomic_t g_stop = 0;
+
+    void onSignal(int)
+    {
+        g_stop = 1;
+    }
+
+    struct Options
+    {
+        std::string dir;
+        int latencyMs = 0;
+        int errorEvery = 0;  // Every Nth command gets an ERROR reply
+        int closeAfter = 0;  // Send CLOSE after N frames on a connection
+        int dropAfter = 0;   // Hang up without CLOSE after N frames on a connection
+        int durationSec = 0; // Exit after this long (0 = until interrupted)
+        std::string recordPath;
+        int maxIn5s = 0;     // Pacing limits checked on exit (0 = not checked)
+        int maxIn15s = 0;
+        int minFrames = 0;
+    };
+
+    /**
+     * @brief Records frames as JSON lines and keeps the pacing statistics
+     */
+    class Recorder
+    {
+    public:
+        Recorder(std::ostream &out) : m_out(out), m_start(std::chrono::steady_clock::now())
+        {
+        }
+
+        double now() const
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+        }
+
+        // Wall-clock time, to line records up with mock_plex's
+        static int64_t wallMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        void frame(int connection, const char *direction, uint32_t opcode, const std::string &payload)
+        {
+            double t = now();
+            json line = {{"t_ms", t}, {"wall_ms", wallMs()}, {"conn", connection}, {"dir", direction}, {"op", opcode}, {"len", payload.size()}};
+
+            try
+            {
+                json body = json::parse(payload);
+                if (body.is_object())
+                {
+                    for (const char *key : {"cmd", "evt", "nonce"})
+                    {
+                        if (body.contains(key))
+                        {
+                            line[key] = body[key];
+                        }
+                    }
+                    if (std::string(direction) == "in" && body.value("cmd", "") == "SET_ACTIVITY")
+                    {
+                        m_activityTimes.push_back(t);
+                    }
+                }
+            }
+            catch (const std::exception &)
+            {
+                // Not JSON; length is recorded anyway
+            }
+
+            m_frames[std::string(direction) + " op" + std::to_string(opcode)]++;
+            m_out << line.dump() << "\n";
+            m_out.flush();
+        }
+
+        void event(int connection, const std::string &what)
+        {
+            json line = {{"t_ms", now()}, {"wall_ms", wallMs()}, {"conn", connection}, {"event", what}};
+            m_out << line.dump() << "\n";
+            m_out.flush();
+        }
+
+        void summary(int connections) const
+        {
+            std::cerr << "\n--- mock_discord summary ---\n";
+            std::cerr << "connections: " << connections << "\n";
+            for (const auto &entry : m_frames)
+            {
+                std::cerr << entry.first << ": " << entry.second << "\n";
+            }
+
+            std::cerr << "SET_ACTIVITY frames: " << m_activityTimes.size() << "\n";
+            if (m_activityTimes.size() >= 2)
+            {
+                double minGap = 1e18;
+                for (size_t i = 1; i < m_activityTimes.size(); i++)
+                {
+                    minGap = (std::min)(minGap, m_activityTimes[i] - m_activityTimes[i - 1]);
+                }
+                double span = m_activityTimes.back() - m_activityTimes.front();
+                std::cerr << "min gap: " << minGap << " ms\n";
+                std::cerr << "max in any 5 s: " << maxInWindow(5000) << "\n";
+                std::cerr << "max in any 15 s: " << maxInWindow(15000) << "\n";
+                std::cerr << "mean rate: " << (m_activityTimes.size() - 1) * 1000.0 / span << " frames/s\n";
+            }
+        }
+
+        /**
+         * @brief Checks the SET_ACTIVITY pacing against the limits in options
+         * @return false (after printing why) if a limit was broken
+         */
+        bool checkPacing(const Options &options) const
+        {
+            bool ok = true;
+            if (options.maxIn5s > 0 && maxInWindow(5000) > static_cast<size_t>(options.maxIn5s))
+            {
+                std::cerr << "pacing check failed: " << maxInWindow(5000) << " frames in 5 s, limit "
+                          << options.maxIn5s << "\n";
+                ok = false;
+            }
+            if (options.maxIn15s > 0 && maxInWindow(15000) > static_cast<size_t>(options.maxIn15s))
+            {
+                std::cerr << "pacing check failed: " << maxInWindow(15000) << " frames in 15 s, limit "
+                          << options.maxIn15s << "\n";
+                ok = false;
+            }
+            if (m_activityTimes.size() < static_cast<size_t>(options.minFrames))
+            {
+                std::cerr << "pacing check failed: " << m_activityTimes.size() << " frames, expected at least "
+                          << options.minFrames << "\n";
+                ok = false;
+            }
+            return ok;
+        }
+
+    private:
+        size_t maxInWindow(double windowMs) const
+        {
+            size_t best = 0;
+            size_t first = 0;
+            for (size_t last = 0; last < m_activityTimes.size(); last++)
+            {
+                while (m_activityTimes[last] - m_activityTimes[first] >= windowMs)
+                {
+                    first++;
+                }
+                best = (std::max)(best, last - first + 1);
+            }
+            return best;
+        }
+
+        std::ostream &m_out;
+        std::chrono::steady_clock::time_point m_start;
+        std::map<std::string, uint64_t> m_frames;
+        std::vector<double> m_activityTimes;
+    };
+
+    bool readExact(int fd, char *buf, size_t len)
+    {
+        size_t total = 0;
+        while (total < len)
+        {
+            ssize_t n = read(fd, buf + total, len - total);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            total += n;
+        }
+        return true;
+    }
+
+    bool readFrame(int fd, uint32_t &opcode, std::string &payload)
+    {
+        uint32_t header[2];
+        if (!readExact(fd, reinterpret_cast<char *>(header), sizeof(header)))
+        {
+            return false;
+        }
+        opcode = header[0];
+        if (header[1] > MAX_FRAME_SIZE)
+        {
+            std::cerr << "Frame length " << header[1] << " exceeds limit, dropping client\n";
+            return false;
+        }
+        payload.resize(header[1]);
+        return header[1] == 0 || readExact(fd, &payload[0], header[1]);
+    }
+
+    bool writeFrame(int fd, uint32_t opcode, const std::string &payload)
+    {
+        std::string frame(8, '\0');
+        uint32_t header[2] = {opcode, static_cast<uint32_t>(payload.size())};
+        memcpy(&frame[0], header, sizeof(header));
+        frame += payload;
+
+        size_t total = 0;
+        while (total < frame.size())
+        {
+            ssize_t n = send(fd, frame.data() + total, frame.size() - total, 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            total += n;
+        }
+        return true;
+    }
+
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    bool expired(const Options &options, Deadline deadline)
+    {
+        return options.durationSec > 0 && std::chrono::steady_clock::now() >= deadline;
+    }
+
+    /**
+     * @brief Serves one client until it disconnects, an injected disconnect fires,
+     *        or the server is stopped
+     */
+    void serveClient(int fd, int connection, const Options &options, Recorder &recorder, Deadline deadline)
+    {
+        int frames = 0;
+        int commands = 0;
+
+        auto reply = [&](uint32_t opcode, const json &body)
+        {
+            if (options.latencyMs > 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(options.latencyMs));
+            }
+            std::string payload = body.is_null() ? std::string("{}") : body.dump();
+            recorder.frame(connection, "out", opcode, payload);
+            return writeFrame(fd, opcode, payload);
+        };
+
+        while (!g_stop && !expired(options, deadline))
+        {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            int ready = poll(&pfd, 1, POLL_INTERVAL_MS);
+            if (ready == 0 || (ready < 0 && errno == EINTR))
+            {
+                continue;
+            }
+
+            uint32_t opcode;
+            std::string payload;
+            if (ready < 0 || !readFrame(fd, opcode, payload))
+            {
+                recorder.event(connection, "client disconnected");
+                return;
+            }
+            recorder.frame(connection, "in", opcode, payload);
+            frames++;
+
+            if (options.dropAfter > 0 && frames >= options.dropAfter)
+            {
+                recorder.event(connection, "injected drop");
+                return;
+            }
+            if (options.closeAfter > 0 && frames >= options.closeAfter)
+            {
+                json close = {{"code", 1000}, {"message", "Injected close"}};
+                recorder.frame(connection, "out", OP_CLOSE, close.dump());
+                writeFrame(fd, OP_CLOSE, close.dump());
+                recorder.event(connection, "injected close");
+                return;
+            }
+
+            json body = json::parse(payload, nullptr, false);
+            bool ok = true;
+            if (opcode == OP_HANDSHAKE)
+            {
+                ok = reply(OP_FRAME, {{"cmd", "DISPATCH"},
+                                      {"evt", "READY"},
+                                      {"nonce", nullptr},
+                                      {"data", {{"v", 1}, {"user", {{"id", "0"}, {"username", "mock"}}}}}});
+            }
+            else if (opcode == OP_PING)
+            {
+                if (options.latencyMs > 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(options.latencyMs));
+                }
+                recorder.frame(connection, "out", OP_PONG, payload);
+                ok = writeFrame(fd, OP_PONG, payload);
+            }
+            else if (opcode == OP_CLOSE)
+            {
+                recorder.event(connection, "client sent CLOSE");
+                return;
+            }
+            else if (opcode == OP_FRAME && body.is_object())
+            {
+                commands++;
+                json nonce = body.value("nonce", json());
+                std::string cmd = body.value("cmd", "");
+                if (options.errorEvery > 0 && commands % options.errorEvery == 0)
+                {
+                    ok = reply(OP_FRAME, {{"cmd", cmd},
+                                          {"evt", "ERROR"},
+                                          {"nonce", nonce},
+                                          {"data", {{"code", 4000}, {"message", "Injected error"}}}});
+                }
+                else
+                {
+                    json data = nullptr;
+                    if (body.contains("args") && body["args"].is_object() && body["args"].contains("activity"))
+                    {
+                        data = body["args"]["activity"];
+                    }
+                    ok = reply(OP_FRAME, {{"cmd", cmd}, {"evt", nullptr}, {"nonce", nonce}, {"data", data}});
+                }
+            }
+
+            if (!ok)
+            {
+                recorder.event(connection, "write failed");
+                return;
+            }
+        }
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                return false;
+            }
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Missing value for " << arg << "\n";
+                return false;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--dir")
+                options.dir = value;
+            else if (arg == "--latency")
+                options.latencyMs = std::atoi(value.c_str());
+            else if (arg == "--error-every")
+                options.errorEvery = std::atoi(value.c_str());
+            else if (arg == "--close-after")
+                options.closeAfter = std::atoi(value.c_str());
+            else if (arg == "--drop-after")
+                options.dropAfter = std::atoi(value.c_str());
+            else if (arg == "--duration")
+                options.durationSec = std::atoi(value.c_str());
+            else if (arg == "--record")
+                options.recordPath = value;
+            else if (arg == "--max-in-5s")
+                options.maxIn5s = std::atoi(value.c_str());
+            else if (arg == "--max-in-15s")
+                options.maxIn15s = std::atoi(value.c_str());
+            else if (arg == "--min-frames")
+                options.minFrames = std::atoi(value.c_str());
+            else
+            {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: mock_discord [--dir DIR] [--latency MS] [--error-every N] [--close-after N]\n"
+                     "                    [--drop-after N] [--duration SECONDS] [--record FILE]\n"
+                     "                    [--max-in-5s N] [--max-in-15s N] [--min-frames N]\n";
+        return 2;
+    }
+
+    if (options.dir.empty())
+    {
+        char tmpl[] = "/tmp/mock-discord-XXXXXX";
+        if (!mkdtemp(tmpl))
+        {
+            std::cerr << "mkdtemp failed: " << strerror(errno) << "\n";
+            return 1;
+        }
+        options.dir = tmpl;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN); // A vanished client shows up as a failed write
+
+    std::string path = options.dir + "/discord-ipc-0";
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        std::cerr << "Socket path too long: " << path << "\n";
+        return 1;
+    }
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    unlink(path.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listener, 4) != 0)
+    {
+        std::cerr << "Failed to listen on " << path << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    std::cerr << "Listening on " << path << "\n";
+    std::cerr << "Run the client with XDG_RUNTIME_DIR=" << options.dir << "\n";
+
+    std::ofstream recordFile;
+    if (!options.recordPath.empty())
+    {
+        recordFile.open(options.recordPath);
+    }
+    Recorder recorder(recordFile.is_open() ? static_cast<std::ostream &>(recordFile) : std::cout);
+
+    Deadline deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.durationSec);
+    int connections = 0;
+    while (!g_stop && !expired(options, deadline))
+    {
+        struct pollfd pfd = {listener, POLLIN, 0};
+        if (poll(&pfd, 1, POLL_INTERVAL_MS) <= 0)
+        {
+            continue;
+        }
+
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            continue;
+        }
+        connections++;
+        recorder.event(connections, "client connected");
+
+        serveClient(client, connections, options, recorder, deadline);
+        close(client);
+    }
+
+    close(listener);
+    unlink(path.c_str());
+    recorder.summary(connections);
+    return recorder.checkPacing(options) ? 0 : 1;
+}
@@ -0,0 +1,860 @@
+/**
+ * Mock Plex Media Server for end-to-end latency benchmarking
+ *
+ * A small HTTP/1.1 server that stands in for every remote service PresenceForPlex talks
+ * to: plex.tv (pins, user, resources), the Plex Media Server (/identity, the
+ * /:/eventsource/notifications SSE stream, /status/sessions, /library/metadata/...),
+ * the TMDB images API and the Jikan anime search. Responses come from the fixtures in
+ * tools/fixtures/plex; the SSE stream plays scenario.json, moving to the next item
+ * every --events-per-item events. Latency and failures can be injected per path, and
+ * every request and emitted event is recorded as a JSON line with a timestamp.
+ *
+ * Usage:
+ *   mock_plex [--port PORT] [--fixtures DIR] [--latency MS] [--route-latency PREFIX=MS]
+ *             [--fail-every N] [--fail-path PREFIX] [--event-interval MS]
+ *             [--events-per-item N] [--sse-drop-after N] [--duration SECONDS]
+ *             [--record FILE]
+ *
+ * Point the client at it with PRESENCE_PLEX_TV_URL, PRESENCE_TMDB_API_URL and
+ * PRESENCE_JIKAN_API_URL set to the printed base URL and a fresh config directory;
+ * the PIN is authorized on the first poll and resources.json lists this server.
+ * The "wall_ms" field of the records lines up with mock_discord's, so the delay from
+ * an SSE event to the SET_ACTIVITY frame it causes can be read off the two files.
+ */
+
+// Standard library headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Platform-specific headers
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Third-party headers
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+#ifndef MOCK_PLEX_FIXTURE_DIR
+#define MOCK_PLEX_FIXTURE_DIR "tools/fixtures/plex"
+#endif
+
+namespace
+{
+    constexpr const char *SSE_PATH = "/:/eventsource/notifications";
+    constexpr const char *BASE_URL_PLACEHOLDER = "{{BASE_URL}}";
+    constexpr const char *MOCK_AUTH_TOKEN = "mock-auth-token";
+    constexpr int MOCK_PIN_ID = 4242;
+    constexpr const char *MOCK_PIN_CODE = "MOCK";
+
+    constexpr size_t MAX_REQUEST_HEADER_SIZE = 64 * 1024;
+    constexpr size_t MAX_REQUEST_BODY_SIZE = 1024 * 1024;
+    constexpr size_t EVENT_HISTORY = 64;
+    constexpr int POLL_INTERVAL_MS = 100;
+
+    volatile std::sig_atomic_t g_stop = 0;
+
+    void onSignal(int)
+    {
+        g_stop = 1;
+    }
+
+    struct Options
+    {
+        int port = 32400;
+        std::string fixtureDir = MOCK_PLEX_FIXTURE_DIR;
+        int latencyMs = 0;
+        std::vector<std::pair<std::string, int>> routeLatency; // Path prefix, latency
+        int failEvery = 0;      // Every Nth matching request gets a 503
+        std::string failPath;   // Only requests under this prefix count (empty = all)
+        int eventIntervalMs = 1000;
+        int eventsPerItem = 5;
+        int sseDropAfter = 0;   // Hang up an SSE stream after N events
+        int durationSec = 0;    // Exit after this long (0 = until interrupted)
+        std::string recordPath;
+    };
+
+    struct Request
+    {
+        std::string method;
+        std::string path;
+        std::string query;
+        std::map<std::string, std::string> headers; // Lower-case names
+        std::string body;
+    };
+
+    struct Response
+    {
+        int status = 200;
+        std::string contentType = "application/json";
+        std::string body;
+    };
+
+    /**
+     * @brief Records requests and events as JSON lines
+     */
+    class Recorder
+    {
+    public:
+        Recorder(std::ostream &out) : m_out(out), m_start(std::chrono::steady_clock::now())
+        {
+        }
+
+        void write(json line)
+        {
+            auto wall = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+            line["t_ms"] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+            line["wall_ms"] = wall.count();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_out << line.dump() << "\n";
+            m_out.flush();
+        }
+
+        void request(int connection, const Request &request, int status, double elapsedMs)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_statusCounts[status]++;
+                m_routeCounts[request.path.substr(0, request.path.find('/', 1))]++;
+            }
+            write({{"conn", connection}, {"method", request.method}, {"path", request.path},
+                   {"status", status}, {"elapsed_ms", elapsedMs}});
+        }
+
+        void summary(int connections) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::cerr << "\n--- mock_plex summary ---\n";
+            std::cerr << "connections: " << connections << "\n";
+            for (const auto &entry : m_routeCounts)
+            {
+                std::cerr << entry.first << ": " << entry.second << " requests\n";
+            }
+            for (const auto &entry : m_statusCounts)
+            {
+                std::cerr << "status " << entry.first << ": " << entry.second << "\n";
+            }
+        }
+
+    private:
+        std::ostream &m_out;
+        std::chrono::steady_clock::time_point m_start;
+        mutable std::mutex m_mutex;
+        std::map<int, uint64_t> m_statusCounts;
+        std::map<std::string, uint64_t> m_routeCounts;
+    };
+
+    /**
+     * @brief Plays scenario.json as PlaySessionStateNotifications
+     *
+     * Advances only while at least one SSE stream is open, so a run starts when the
+     * client subscribes. Streams read the recent events by sequence number, and
+     * /status/sessions reports the session currently playing.
+     */
+    class Scenario
+    {
+    public:
+        struct Event
+        {
+            uint64_t seq;
+            std::string name;
+            json data;
+        };
+
+        Scenario(json items, const Options &options, Recorder &recorder)
+            : m_items(std::move(items)), m_options(options), m_recorder(recorder)
+        {
+        }
+
+        void run()
+        {
+            size_t item = 0;
+            int emitted = 0;
+            int64_t viewOffset = 0;
+
+            while (!g_stop)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_cv.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL_MS), [this]()
+                                  { return m_subscribers > 0; });
+                    if (m_subscribers == 0 || m_items.empty())
+                    {
+                        continue;
+                    }
+                }
+
+                const json &current = m_items[item];
+                bool last = emitted + 1 >= m_options.eventsPerItem;
+                std::string state = last ? "stopped" : "playing";
+                publish(current, state, viewOffset);
+
+                viewOffset += m_options.eventIntervalMs;
+                if (++emitted >= m_options.eventsPerItem)
+                {
+                    emitted = 0;
+                    viewOffset = 0;
+                    item = (item + 1) % m_items.size();
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(m_options.eventIntervalMs));
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cv.notify_all();
+        }
+
+        void subscribe(bool add)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_subscribers += add ? 1 : -1;
+            m_cv.notify_all();
+        }
+
+        /**
+         * @brief Waits for the event after afterSeq; false on timeout or shutdown
+         */
+        bool next(uint64_t afterSeq, Event &event)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL_MS), [&]()
+                          { return g_stop || (!m_events.empty() && m_events.back().seq > afterSeq); });
+            for (const auto &candidate : m_events)
+            {
+                if (candidate.seq > afterSeq)
+                {
+                    event = candidate;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        uint64_t lastSeq()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_events.empty() ? 0 : m_events.back().seq;
+        }
+
+        json sessions()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            json metadata = json::array();
+            if (!m_session.is_null())
+            {
+                metadata.push_back(m_session);
+            }
+            return {{"MediaContainer", {{"size", metadata.size()}, {"Metadata", metadata}}}};
+        }
+
+    private:
+        void publish(const json &item, const std::string &state, int64_t viewOffset)
+        {
+            json notification = {{"sessionKey", item.value("sessionKey", "1")},
+                                 {"clientIdentifier", "mock-player"},
+                                 {"guid", ""},
+                                 {"ratingKey", item.value("key", "").substr(item.value("key", "").rfind('/') + 1)},
+                                 {"url", ""},
+                                 {"key", item.value("key", "")},
+                                 {"viewOffset", viewOffset},
+                                 {"playQueueItemID", 1},
+                                 {"state", state}};
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Event event{++m_seq, "playing", {{"PlaySessionStateNotification", notification}}};
+            m_events.push_back(event);
+            if (m_events.size() > EVENT_HISTORY)
+            {
+                m_events.pop_front();
+            }
+
+            if (state == "stopped")
+            {
+                m_session = nullptr;
+            }
+            else
+            {
+                m_session = {{"sessionKey", notification["sessionKey"]},
+                             {"key", notification["key"]},
+                             {"viewOffset", viewOffset},
+                             {"User", {{"id", "1"}, {"title", item.value("user", "mockuser")}}},
+                             {"Player", {{"state", state}, {"machineIdentifier", "mock-player"}}}};
+            }
+            m_cv.notify_all();
+
+            m_recorder.write({{"event", state}, {"seq", event.seq}, {"key", notification["key"]},
+                              {"sessionKey", notification["sessionKey"]}, {"viewOffset", viewOffset}});
+        }
+
+        json m_items;
+        const Options &m_options;
+        Recorder &m_recorder;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        int m_subscribers = 0;
+        uint64_t m_seq = 0;
+        std::deque<Event> m_events;
+        json m_session;
+    };
+
+    bool loadJson(const std::string &path, json &out)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            std::cerr << "Cannot open fixture " << path << "\n";
+            return false;
+        }
+        out = json::parse(file, nullptr, false);
+        if (out.is_discarded())
+        {
+            std::cerr << "Invalid JSON in fixture " << path << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool startsWith(const std::string &value, const std::string &prefix)
+    {
+        return value.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    std::string statusText(int status)
+    {
+        switch (status)
+        {
+        case 200:
+            return "OK";
+        case 201:
+            return "Created";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return "Unknown";
+        }
+    }
+
+    bool sendAll(int fd, const std::string &data)
+    {
+        size_t total = 0;
+        while (total < data.size())
+        {
+            ssize_t n = send(fd, data.data() + total, data.size() - total, 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            total += n;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads one request from the connection, keeping any pipelined bytes in buffer
+     * @return false if the client went away, sent garbage or the server is stopping
+     */
+    bool readRequest(int fd, std::string &buffer, Request &request)
+    {
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+        {
+            if (g_stop || buffer.size() > MAX_REQUEST_HEADER_SIZE)
+            {
+                return false;
+            }
+
+            struct pollfd pfd = {fd, POLLIN, 0};
+            int ready = poll(&pfd, 1, POLL_INTERVAL_MS);
+            if (ready == 0 || (ready < 0 && errno == EINTR))
+            {
+                continue;
+            }
+
+            char chunk[4096];
+            ssize_t n = ready < 0 ? -1 : recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            buffer.append(chunk, n);
+        }
+
+        std::istringstream head(buffer.substr(0, headerEnd));
+        std::string line;
+        std::string target;
+        std::getline(head, line);
+        std::istringstream requestLine(line);
+        if (!(requestLine >> request.method >> target))
+        {
+            return false;
+        }
+
+        size_t queryStart = target.find('?');
+        request.path = target.substr(0, queryStart);
+        request.query = queryStart == std::string::npos ? "" : target.substr(queryStart + 1);
+
+        while (std::getline(head, line))
+        {
+            size_t colon = line.find(':');
+            if (colon == std::string::npos)
+            {
+                continue;
+            }
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            size_t valueStart = line.find_first_not_of(' ', colon + 1);
+            size_t valueEnd = line.find_last_not_of("\r ");
+            request.headers[name] = valueStart == std::string::npos ? "" : line.substr(valueStart, valueEnd - valueStart + 1);
+        }
+        buffer.erase(0, headerEnd + 4);
+
+        size_t contentLength = 0;
+        auto it = request.headers.find("content-length");
+        if (it != request.headers.end())
+        {
+            contentLength = std::strtoul(it->second.c_str(), nullptr, 10);
+        }
+        if (contentLength > MAX_REQUEST_BODY_SIZE)
+        {
+            return false;
+        }
+        while (buffer.size() < contentLength)
+        {
+            char chunk[4096];
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            buffer.append(chunk, n);
+        }
+        request.body = buffer.substr(0, contentLength);
+        buffer.erase(0, contentLength);
+        return true;
+    }
+
+    /**
+     * @brief Serves the fixtures and the scenario over HTTP
+     */
+    class MockPlex
+    {
+    public:
+        MockPlex(const Options &options, Recorder &recorder, Scenario &scenario)
+            : m_options(options), m_recorder(recorder), m_scenario(scenario)
+        {
+        }
+
+        bool loadFixtures(const std::string &baseUrl)
+        {
+            const std::string &dir = m_options.fixtureDir;
+            json resources;
+            if (!loadJson(dir + "/user.json", m_user) ||
+                !loadJson(dir + "/resources.json", resources) ||
+                !loadJson(dir + "/metadata.json", m_metadata) ||
+                !loadJson(dir + "/tmdb_images.json", m_tmdbImages) ||
+                !loadJson(dir + "/jikan_anime.json", m_jikanAnime))
+            {
+                return false;
+            }
+
+            // Every connection URI in resources.json points back at this server
+            m_resources = resources.dump();
+            size_t pos;
+            while ((pos = m_resources.find(BASE_URL_PLACEHOLDER)) != std::string::npos)
+            {
+                m_resources.replace(pos, strlen(BASE_URL_PLACEHOLDER), baseUrl);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Serves one client connection until it closes or the server stops
+         */
+        void serveConnection(int fd, int connection)
+        {
+            std::string buffer;
+            Request request;
+            while (!g_stop && readRequest(fd, buffer, request))
+            {
+                auto started = std::chrono::steady_clock::now();
+                int delayMs = latencyFor(request.path);
+                if (delayMs > 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+                }
+
+                Response response;
+                bool injected = injectFailure(request.path);
+                if (injected)
+                {
+                    response.status = 503;
+                    response.body = R"({"error":"Injected failure"})";
+                }
+                else if (request.method == "GET" && request.path == SSE_PATH)
+                {
+                    m_recorder.request(connection, request, 200, elapsedMs(started));
+                    streamEvents(fd, connection);
+                    return;
+                }
+                else
+                {
+                    response = route(request);
+                }
+
+                m_recorder.request(connection, request, response.status, elapsedMs(started));
+
+                auto it = request.headers.find("connection");
+                bool keepAlive = it == request.headers.end() || it->second != "close";
+                std::ostringstream head;
+                head << "HTTP/1.1 " << response.status << " " << statusText(response.status) << "\r\n"
+                     << "Content-Type: " << response.contentType << "\r\n"
+                     << "Content-Length: " << response.body.size() << "\r\n"
+                     << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n";
+                if (!sendAll(fd, head.str() + response.body) || !keepAlive)
+                {
+                    return;
+                }
+                request = Request();
+            }
+        }
+
+    private:
+        static double elapsedMs(std::chrono::steady_clock::time_point started)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        }
+
+        int latencyFor(const std::string &path) const
+        {
+            for (const auto &entry : m_options.routeLatency)
+            {
+                if (startsWith(path, entry.first))
+                {
+                    return entry.second;
+                }
+            }
+            return m_options.latencyMs;
+        }
+
+        bool injectFailure(const std::string &path)
+        {
+            if (m_options.failEvery <= 0 || !startsWith(path, m_options.failPath))
+            {
+                return false;
+            }
+            return ++m_failCounter % m_options.failEvery == 0;
+        }
+
+        Response route(const Request &request)
+        {
+            Response response;
+            const std::string &path = request.path;
+
+            if (path == "/api/v2/pins" && request.method == "POST")
+            {
+                response.status = 201;
+                response.body = json({{"id", MOCK_PIN_ID}, {"code", MOCK_PIN_CODE}, {"authToken", nullptr}}).dump();
+            }
+            else if (startsWith(path, "/api/v2/pins/"))
+            {
+                response.body = json({{"id", MOCK_PIN_ID}, {"code", MOCK_PIN_CODE}, {"authToken", MOCK_AUTH_TOKEN}}).dump();
+            }
+            else if (path == "/api/v2/user")
+            {
+                response.body = m_user.dump();
+            }
+            else if (path == "/api/v2/resources")
+            {
+                response.body = m_resources;
+            }
+            else if (path == "/identity")
+            {
+                response.body = json({{"MediaContainer", {{"size", 0}, {"claimed", true}, {"machineIdentifier", "mock-plex-server"}, {"version", "1.40.0.7998"}}}}).dump();
+            }
+            else if (path == "/status/sessions")
+            {
+                response.body = m_scenario.sessions().dump();
+            }
+            else if (startsWith(path, "/library/metadata/"))
+            {
+                auto it = m_metadata.find(path);
+                if (it == m_metadata.end())
+                {
+                    response.status = 404;
+                    return response;
+                }
+                response.body = json({{"MediaContainer", {{"size", 1}, {"Metadata", json::array({*it})}}}}).dump();
+            }
+            else if (startsWith(path, "/3/movie/") || startsWith(path, "/3/tv/"))
+            {
+                // /3/<movie|tv>/<id>/images
+                std::string rest = path.substr(path.find('/', 3) + 1);
+                std::string id = rest.substr(0, rest.find('/'));
+                auto it = m_tmdbImages.find(id);
+                if (it == m_tmdbImages.end())
+                {
+                    response.status = 404;
+                    response.body = R"({"success":false,"status_code":34,"status_message":"The resource you requested could not be found."})";
+                    return response;
+                }
+                response.body = it->dump();
+            }
+            else if (path == "/v4/anime")
+            {
+                response.body = m_jikanAnime.dump();
+            }
+            else
+            {
+                response.status = 404;
+            }
+            return response;
+        }
+
+        void streamEvents(int fd, int connection)
+        {
+            std::string head = "HTTP/1.1 200 OK\r\n"
+                               "Content-Type: text/event-stream\r\n"
+                               "Cache-Control: no-cache\r\n"
+                               "Connection: close\r\n\r\n";
+            if (!sendAll(fd, head))
+            {
+                return;
+            }
+
+            uint64_t seq = m_scenario.lastSeq();
+            m_scenario.subscribe(true);
+            m_recorder.write({{"conn", connection}, {"event", "sse subscribed"}});
+
+            int sent = 0;
+            while (!g_stop)
+            {
+                Scenario::Event event;
+                if (!m_scenario.next(seq, event))
+                {
+                    // Notice a client that hung up while no events were due
+                    struct pollfd pfd = {fd, POLLIN, 0};
+                    char probe;
+                    if (poll(&pfd, 1, 0) > 0 && recv(fd, &probe, 1, MSG_PEEK) <= 0)
+                    {
+                        break;
+                    }
+                    continue;
+                }
+                seq = event.seq;
+
+                std::string frame = "event: " + event.name + "\ndata: " + event.data.dump() + "\n\n";
+                if (!sendAll(fd, frame))
+                {
+                    break;
+                }
+                if (m_options.sseDropAfter > 0 && ++sent >= m_options.sseDropAfter)
+                {
+                    m_recorder.write({{"conn", connection}, {"event", "injected sse drop"}});
+                    break;
+                }
+            }
+
+            m_scenario.subscribe(false);
+            m_recorder.write({{"conn", connection}, {"event", "sse closed"}});
+        }
+
+        const Options &m_options;
+        Recorder &m_recorder;
+        Scenario &m_scenario;
+
+        json m_user;
+        std::string m_resources;
+        json m_metadata;
+        json m_tmdbImages;
+        json m_jikanAnime;
+        std::atomic<uint64_t> m_failCounter{0};
+    };
+
+    bool parseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                return false;
+            }
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Missing value for " << arg << "\n";
+                return false;
+            }
+            std::string value = argv[++i];
+
+            if (arg == "--port")
+                options.port = std::atoi(value.c_str());
+            else if (arg == "--fixtures")
+                options.fixtureDir = value;
+            else if (arg == "--latency")
+                options.latencyMs = std::atoi(value.c_str());
+            else if (arg == "--route-latency")
+            {
+                size_t eq = value.rfind('=');
+                if (eq == std::string::npos)
+                {
+                    std::cerr << "--route-latency expects PREFIX=MS\n";
+                    return false;
+                }
+                options.routeLatency.emplace_back(value.substr(0, eq), std::atoi(value.c_str() + eq + 1));
+            }
+            else if (arg == "--fail-every")
+                options.failEvery = std::atoi(value.c_str());
+            else if (arg == "--fail-path")
+                options.failPath = value;
+            else if (arg == "--event-interval")
+                options.eventIntervalMs = (std::max)(std::atoi(value.c_str()), 1);
+            else if (arg == "--events-per-item")
+                options.eventsPerItem = (std::max)(std::atoi(value.c_str()), 2); // At least one playing, then stopped
+            else if (arg == "--sse-drop-after")
+                options.sseDropAfter = std::atoi(value.c_str());
+            else if (arg == "--duration")
+                options.durationSec = std::atoi(value.c_str());
+            else if (arg == "--record")
+                options.recordPath = value;
+            else
+            {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: mock_plex [--port PORT] [--fixtures DIR] [--latency MS] [--route-latency PREFIX=MS]\n"
+                     "                 [--fail-every N] [--fail-path PREFIX] [--event-interval MS]\n"
+                     "                 [--events-per-item N] [--sse-drop-after N] [--duration SECONDS]\n"
+                     "                 [--record FILE]\n";
+        return 2;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN); // A vanished client shows up as a failed write
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(options.port));
+    socklen_t addrLen = sizeof(addr);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(listener, 16) != 0 || getsockname(listener, reinterpret_cast<sockaddr *>(&addr), &addrLen) != 0)
+    {
+        std::cerr << "Failed to listen on port " << options.port << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    std::string baseUrl = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+
+    std::ofstream recordFile;
+    if (!options.recordPath.empty())
+    {
+        recordFile.open(options.recordPath);
+    }
+    Recorder recorder(recordFile.is_open() ? static_cast<std::ostream &>(recordFile) : std::cout);
+
+    json items;
+    if (!loadJson(options.fixtureDir + "/scenario.json", items) || !items.is_array())
+    {
+        return 1;
+    }
+    Scenario scenario(items, options, recorder);
+    MockPlex server(options, recorder, scenario);
+    if (!server.loadFixtures(baseUrl))
+    {
+        return 1;
+    }
+
+    std::cerr << "Listening on " << baseUrl << "\n";
+    std::cerr << "Run the client with PRESENCE_PLEX_TV_URL=" << baseUrl << " PRESENCE_TMDB_API_URL=" << baseUrl
+              << " PRESENCE_JIKAN_API_URL=" << baseUrl << "\n";
+
+    std::thread scenarioThread(&Scenario::run, &scenario);
+    std::vector<std::thread> connectionThreads;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.durationSec);
+    int connections = 0;
+    while (!g_stop && (options.durationSec <= 0 || std::chrono::steady_clock::now() < deadline))
+    {
+        struct pollfd pfd = {listener, POLLIN, 0};
+        if (poll(&pfd, 1, POLL_INTERVAL_MS) <= 0)
+        {
+            continue;
+        }
+
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            continue;
+        }
+        int connection = ++connections;
+        connectionThreads.emplace_back([&server, client, connection]()
+                                       {
+            server.serveConnection(client, connection);
+            close(client); });
+    }
+
+    g_stop = 1;
+    close(listener);
+    for (auto &thread : connectionThreads)
+    {
+        thread.join();
+    }
+    scenarioThread.join();
+    recorder.summary(connections);
+    return 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * Benchmark of the SAX extractors in plex_sax.h against building a JSON DOM
+ *
+ * Times SessionListExtractor::collect on a /status/sessions body and
+ * MetadataExtractor::extractFirst on a /library/metadata body, next to the DOM code
+ * they replaced (parse everything, then walk the tree or copy Metadata[0]), and
+ * reports time and heap allocations per parse.
+ *
+ * Usage:
+ *   sax_bench [--sessions N] [--iterations N]
+ *
+ * The payloads are synthetic but follow the shape of real Plex responses, including
+ * the Media/Part/Stream, TranscodeSession and Role arrays the extractors skip.
+ */
+
+// Standard library headers
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Third-party headers
+#include <nlohmann/json.hpp>
+
+// Project headers
+#include "bench_support.h"
+#include "plex_sax.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+    json streams()
+    {
+        json list = json::array();
+        for (int i = 0; i < 6; i++)
+        {
+            list.push_back({{"id", 1000 + i},
+                            {"streamType", i == 0 ? 1 : 2},
+                            {"codec", i == 0 ? "hevc" : "eac3"},
+                            {"language", "English"},
+                            {"languageCode", "eng"},
+                            {"displayTitle", "English (EAC3 5.1)"},
+                            {"extendedDisplayTitle", "English (EAC3 5.1) - Default"},
+                            {"bitrate", 640},
+                            {"default", i < 2}});
+        }
+        return list;
+    }
+
+    json media()
+    {
+        return json::array({{{"id", 5001},
+                             {"duration", 2640000},
+                             {"bitrate", 9000},
+                             {"width", 3840},
+                             {"height", 2160},
+                             {"videoCodec", "hevc"},
+                             {"audioCodec", "eac3"},
+                             {"container", "mkv"},
+                             {"Part", json::array({{{"id", 6001},
+                                                    {"key", "/library/parts/6001/1700000000/file.mkv"},
+                                                    {"file", "/data/media/tv/Some Show/Season 01/Some Show - S01E01 - Pilot.mkv"},
+                                                    {"size", 3200000000LL},
+                                                    {"Stream", streams()}}})}}});
+    }
+
+    json sessionItem(int index)
+    {
+        std::string key = std::to_string(20000 + index);
+        return {{"sessionKey", std::to_string(index + 1)},
+                {"key", "/library/metadata/" + key},
+                {"ratingKey", key},
+                {"type", "episode"},
+                {"title", "Episode " + std::to_string(index)},
+                {"grandparentTitle", "Some Show"},
+                {"summary", std::string(400, 's')},
+                {"viewOffset", 120000 + index},
+                {"duration", 2640000},
+                {"Media", media()},
+                {"User", {{"id", std::to_string(index)}, {"title", "user" + std::to_string(index)}, {"thumb", "https://plex.tv/users/abc/avatar"}}},
+                {"Player", {{"address", "10.0.0.2"}, {"machineIdentifier", "player-" + key}, {"platform", "Windows"}, {"product", "Plex for Windows"}, {"state", "playing"}}},
+                {"Session", {{"id", "session-" + key}, {"bandwidth", 20000}, {"location", "lan"}}},
+                {"TranscodeSession", {{"key", "/transcode/sessions/" + key}, {"throttled", false}, {"progress", 12.5}, {"speed", 3.1}, {"videoDecision", "copy"}, {"audioDecision", "transcode"}}}};
+    }
+
+    std::string sessionsBody(int count)
+    {
+        json items = json::array();
+        for (int i = 0; i < count; i++)
+        {
+            items.push_back(sessionItem(i));
+        }
+        return json({{"MediaContainer", {{"size", count}, {"Metadata", items}}}}).dump();
+    }
+
+    std::string metadataBody()
+    {
+        json roles = json::array();
+        for (int i = 0; i < 40; i++)
+        {
+            roles.push_back({{"id", i}, {"tag", "Actor " + std::to_string(i)}, {"role", "Character " + std::to_string(i)}, {"thumb", "https://metadata-static.plex.tv/people/actor.jpg"}});
+        }
+        json item = sessionItem(0);
+        item.erase("User");
+        item.erase("Player");
+        item.erase("Session");
+        item.erase("TranscodeSession");
+        item["parentIndex"] = 1;
+        item["index"] = 1;
+        item["grandparentKey"] = "/library/metadata/19999";
+        item["Guid"] = json::array({{{"id", "imdb://tt0000001"}}, {{"id", "tmdb://100"}}, {{"id", "tvdb://200"}}});
+        item["Genre"] = json::array({{{"tag", "Drama"}}, {{"tag", "Anime"}}});
+        item["Role"] = roles;
+        item["Director"] = json::array({{{"tag", "Director"}}});
+        item["Writer"] = json::array({{{"tag", "Writer"}}});
+        return json({{"MediaContainer", {{"size", 1}, {"Metadata", json::array({item})}}}}).dump();
+    }
+
+    // The DOM code the extractors replaced
+    void collectSessionsDom(const std::string &body, std::vector<SessionListExtractor::Session> &sessions)
+    {
+        json root = json::parse(body);
+        for (const auto &item : root["MediaContainer"]["Metadata"])
+        {
+            SessionListExtractor::Session session;
+            session.sessionKey = item.value("sessionKey", "");
+            session.mediaKey = item.value("key", "");
+            session.viewOffset = item.value("viewOffset", 0);
+            if (item.contains("User"))
+            {
+                session.username = item["User"].value("title", "");
+            }
+            if (item.contains("Player"))
+            {
+                session.state = item["Player"].value("state", "");
+            }
+            sessions.push_back(std::move(session));
+        }
+    }
+
+    json firstMetadataDom(const std::string &body)
+    {
+        json root = json::parse(body);
+        return root["MediaContainer"]["Metadata"][0];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int sessionCount = 200;
+    size_t iterations = 200;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--sessions")
+            sessionCount = std::atoi(argv[i + 1]);
+        else if (arg == "--iterations")
+            iterations = std::strtoul(argv[i + 1], nullptr, 10);
+    }
+    if (argc % 2 == 0 || sessionCount <= 0 || iterations == 0)
+    {
+        std::cerr << "Usage: sax_bench [--sessions N] [--iterations N]\n";
+        return 2;
+    }
+
+    std::string sessions = sessionsBody(sessionCount);
+    std::string metadata = metadataBody();
+    std::cout << "/status/sessions: " << sessionCount << " sessions, " << sessions.size() << " bytes\n";
+    std::cout << "/library/metadata: " << metadata.size() << " bytes\n\n";
+
+    std::vector<SessionListExtractor::Session> list;
+    bench::report("sessions, DOM", bench::measure(iterations, [&]()
+                                                  { list.clear(); collectSessionsDom(sessions, list); }));
+    size_t domCount = list.size();
+    bench::report("sessions, SessionListExtractor", bench::measure(iterations, [&]()
+                                                                   { list.clear(); SessionListExtractor::collect(sessions, list); }));
+    if (list.size() != domCount)
+    {
+        std::cerr << "Extractor found " << list.size() << " sessions, DOM found " << domCount << "\n";
+        return 1;
+    }
+
+    json item;
+    bench::report("metadata, DOM", bench::measure(iterations * 10, [&]()
+                                                  { item = firstMetadataDom(metadata); }));
+    bench::report("metadata, MetadataExtractor", bench::measure(iterations * 10, [&]()
+                                                                { MetadataExtractor::extractFirst(metadata, item); }));
+    return 0;
+}
@@ -0,0 +1,187 @@
+/**
+ * Benchmark of SSEParser against the buffer-and-rescan loop it replaced
+ *
+ * Feeds a Plex notification stream to both parsers in fixed-size chunks (as curl's
+ * write callback would) and reports time, throughput and heap allocations per event.
+ * Large chunks model a burst after a stall, where rescanning from the start of the
+ * buffer and erasing the front per event turns quadratic.
+ *
+ * Usage:
+ *   sse_bench [--input FILE] [--events N] [--iterations N]
+ *
+ * Without --input a stream of Plex-shaped notifications (playing, timeline, activity
+ * and ping events) is generated; --input replays a captured text/event-stream body.
+ */
+
+// Standard library headers
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+// Project headers
+#include "bench_support.h"
+#include "sse_parser.h"
+
+namespace
+{
+    std::string generateStream(int events)
+    {
+        std::string stream;
+        for (int i = 0; i < events; i++)
+        {
+            std::string key = std::to_string(1000 + i % 50);
+            switch (i % 4)
+            {
+            case 0:
+                stream += "event: playing\ndata: {\"PlaySessionStateNotification\":{\"sessionKey\":\"" +
+                          std::to_string(i % 8) + "\",\"clientIdentifier\":\"abcdef0123456789\",\"guid\":\"\","
+                          "\"ratingKey\":\"" + key + "\",\"url\":\"\",\"key\":\"/library/metadata/" + key +
+                          "\",\"viewOffset\":" + std::to_string(i * 1000) + ",\"playQueueItemID\":" +
+                          std::to_string(i) + ",\"playQueueID\":1,\"state\":\"playing\"}}\n\n";
+                break;
+            case 1:
+                stream += "event: timeline\ndata: {\"TimelineEntry\":[{\"identifier\":\"com.plexapp.plugins.library\","
+                          "\"sectionID\":\"2\",\"itemID\":\"" + key + "\",\"type\":4,\"title\":\"Episode\",\"state\":5,"
+                          "\"updatedAt\":1700000000}]}\n\n";
+                break;
+            case 2:
+                stream += "event: activity\ndata: {\"ActivityNotification\":{\"event\":\"updated\",\"uuid\":\"" + key +
+                          "-uuid\",\"Activity\":{\"uuid\":\"" + key + "-uuid\",\"type\":\"library.update.section\","
+                          "\"cancellable\":false,\"userID\":1,\"title\":\"Scanning\",\"subtitle\":\"TV Shows\","
+                          "\"progress\":" + std::to_string(i % 100) + "}}}\n\n";
+                break;
+            default:
+                stream += "event: ping\ndata: {}\n\n";
+                break;
+            }
+        }
+        return stream;
+    }
+
+    // The write callback SSEParser replaced: append, rescan from the start, copy out
+    class RescanParser
+    {
+    public:
+        explicit RescanParser(std::function<void(const std::string &)> handler) : m_handler(std::move(handler))
+        {
+        }
+
+        void feed(const char *data, size_t size)
+        {
+            m_buffer.append(data, size);
+            size_t pos;
+            while ((pos = m_buffer.find("\n\n")) != std::string::npos)
+            {
+                std::string event = m_buffer.substr(0, pos);
+                m_buffer.erase(0, pos + 2);
+
+                size_t dataPos = event.find("data: ");
+                if (dataPos != std::string::npos)
+                {
+                    std::string payload = event.substr(dataPos + 6);
+                    m_handler(payload);
+                }
+            }
+        }
+
+    private:
+        std::function<void(const std::string &)> m_handler;
+        std::string m_buffer;
+    };
+
+    template <typename Parser>
+    void feedInChunks(Parser &parser, const std::string &stream, size_t chunkSize)
+    {
+        for (size_t offset = 0; offset < stream.size(); offset += chunkSize)
+        {
+            parser.feed(stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string inputPath;
+    int generatedEvents = 20000;
+    size_t iterations = 20;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--input")
+            inputPath = argv[i + 1];
+        else if (arg == "--events")
+            generatedEvents = std::atoi(argv[i + 1]);
+        else if (arg == "--iterations")
+            iterations = std::strtoul(argv[i + 1], nullptr, 10);
+    }
+    if (argc % 2 == 0 || generatedEvents <= 0 || iterations == 0)
+    {
+        std::cerr << "Usage: sse_bench [--input FILE] [--events N] [--iterations N]\n";
+        return 2;
+    }
+
+    std::string stream;
+    if (!inputPath.empty())
+    {
+        std::ifstream file(inputPath, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "Cannot open " << inputPath << "\n";
+            return 1;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        stream = contents.str();
+    }
+    else
+    {
+        stream = generateStream(generatedEvents);
+    }
+
+    // Count the events once so results can be reported per event
+    size_t events = 0;
+    SSEParser counter([&](const SSEEvent &)
+                      { events++; });
+    counter.feed(stream.data(), stream.size());
+    if (events == 0)
+    {
+        std::cerr << "No events in the stream\n";
+        return 1;
+    }
+    std::cout << "stream: " << stream.size() << " bytes, " << events << " events\n\n";
+
+    for (size_t chunkSize : {static_cast<size_t>(1500), static_cast<size_t>(64 * 1024)})
+    {
+        size_t delivered = 0;
+        bench::Result rescan = bench::measure(iterations, [&]()
+                                              {
+            RescanParser parser([&](const std::string &data) { delivered += data.size(); });
+            feedInChunks(parser, stream, chunkSize); });
+        bench::Result incremental = bench::measure(iterations, [&]()
+                                                   {
+            SSEParser parser([&](const SSEEvent &event) { delivered += event.data.size(); });
+            feedInChunks(parser, stream, chunkSize); });
+
+        std::cout << chunkSize << "-byte chunks:\n";
+        for (auto entry : {std::make_pair("rescan (per event)", rescan), std::make_pair("SSEParser (per event)", incremental)})
+        {
+            bench::Result perEvent = entry.second;
+            perEvent.nsPerOp /= events;
+            perEvent.opsPerSecond *= events;
+            perEvent.allocationsPerOp /= events;
+            perEvent.bytesPerOp /= events;
+            bench::report(entry.first, perEvent);
+        }
+        std::cout << "  SSEParser throughput: " << stream.size() / incremental.nsPerOp * 1e3 << " MB/s\n\n";
+        if (delivered == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}